@@ -3,6 +3,8 @@
   
   This example demonstrates asynchronous usage of the OLEDKeyboard library.
   The keyboard runs in the background while other tasks can be performed.
+  A status bar is composed with the keyboard into a single frame, so each
+  update sends the display buffer only once.
   
   Hardware Requirements:
   - ESP32/ESP8266 or Arduino compatible board
@@ -24,6 +26,7 @@
 
 #include <U8g2lib.h>
 #include <OLEDKeyboard.h>
+#include <OLEDCompositor.h>
 
 // Initialize display
 U8G2_SSD1306_128X64_NONAME_F_HW_I2C u8g2(U8G2_R0, /* reset=*/ U8X8_PIN_NONE);
@@ -37,6 +40,9 @@ U8G2_SSD1306_128X64_NONAME_F_HW_I2C u8g2(U8G2_R0, /* reset=*/ U8X8_PIN_NONE);
 // Initialize keyboard
 OLEDKeyboard keyboard(&u8g2, UP_PIN, DOWN_PIN, SELECT_PIN);
 
+// Status bar and keyboard share one frame
+OLEDCompositor screen(&u8g2);
+
 // Background task variables
 unsigned long lastLedToggle = 0;
 bool ledState = false;
@@ -68,6 +74,15 @@ void setup() {
   keyboard.setMaxLength(15);  // Limit input to 15 characters
   keyboard.setCursorBlinkInterval(300);  // Faster cursor blink
   
+  // Leave the top rows for the status bar
+  keyboard.setRegion(0, 9, 128, 55);
+  keyboard.setInputAreaHeight(12);
+  keyboard.setKeySize(13, 10);
+  keyboard.setKeySpacing(2, 1);
+  
+  screen.add(drawStatusBar);
+  screen.add(&keyboard);
+  
   Serial.println("OLEDKeyboard Async Example");
   Serial.println("Keyboard runs in background while LED blinks");
   Serial.println("and serial counter updates");
@@ -115,9 +130,22 @@ void backgroundTasks() {
   }
 }
 
+void drawStatusBar(U8G2* display, void* context) {
+  display->setFont(u8g2_font_4x6_tr);
+  
+  String status = "Count " + String(counter) + "  LED " + (ledState ? "on" : "off");
+  display->drawStr(0, 6, status.c_str());
+  
+  String length = String(keyboard.getInputText().length()) + "/15";
+  display->drawStr(128 - display->getStrWidth(length.c_str()), 6, length.c_str());
+}
+
 void handleInputState() {
-  // Update keyboard (non-blocking)
-  if (keyboard.update()) {
+  // Update keyboard (non-blocking), then draw status bar and keyboard
+  bool complete = keyboard.poll();
+  screen.draw();
+  
+  if (complete) {
     // Input completed
     lastInput = keyboard.getInputText();
     currentState = STATE_PROCESSING;
@@ -130,6 +158,7 @@ void handleInputState() {
 void handleProcessingState() {
   // Show processing screen
   u8g2.clearBuffer();
+  u8g2.setFont(u8g2_font_6x10_tr);
   u8g2.drawStr(0, 12, "Processing...");
   u8g2.drawStr(0, 28, lastInput.c_str());
   
@@ -151,6 +180,7 @@ void handleProcessingState() {
 void handleResultState() {
   // Show result screen
   u8g2.clearBuffer();
+  u8g2.setFont(u8g2_font_6x10_tr);
   u8g2.drawStr(0, 12, "Result:");
   u8g2.drawStr(0, 28, "Text length:");
   
@@ -0,0 +1,66 @@
+/*
+  EncoderKeyboard Example
+  
+  This example drives the keyboard with a rotary encoder instead of
+  UP/DOWN buttons. Turning moves the selection (faster spins skip several
+  keys per detent) and pressing the knob selects the key.
+  
+  Hardware Requirements:
+  - ESP32/ESP8266 or Arduino compatible board
+  - SSD1306 OLED Display (128x64) - I2C
+  - Rotary encoder with push button (e.g. KY-040)
+  
+  Connections:
+  - OLED SDA -> GPIO 21 (ESP32) or D2 (ESP8266)
+  - OLED SCL -> GPIO 22 (ESP32) or D1 (ESP8266)
+  - Encoder CLK (A) -> GPIO 2
+  - Encoder DT (B) -> GPIO 3
+  - Encoder SW -> GPIO 4
+  
+  On an Arduino Uno, pins 2 and 3 are the ones with interrupts, so the
+  encoder is decoded in the background there too.
+  
+  Created by Sk Raihan, SKR Electronics Lab
+  https://github.com/skr-electronics-lab
+*/
+
+#include <U8g2lib.h>
+#include <OLEDKeyboard.h>
+
+// Initialize display
+U8G2_SSD1306_128X64_NONAME_F_HW_I2C u8g2(U8G2_R0, /* reset=*/ U8X8_PIN_NONE);
+
+// Pin definitions
+#define ENCODER_A 2
+#define ENCODER_B 3
+#define ENCODER_BUTTON 4
+
+// Initialize encoder and keyboard
+EncoderInput encoder(ENCODER_A, ENCODER_B, ENCODER_BUTTON);
+OLEDKeyboard keyboard(&u8g2, &encoder);
+
+void setup() {
+  Serial.begin(115200);
+  
+  // Initialize display
+  u8g2.begin();
+  
+  // Up to 4 keys per detent when spinning fast
+  encoder.setAcceleration(4);
+  
+  // Initialize keyboard (also starts the encoder)
+  keyboard.begin();
+  
+  Serial.println("OLEDKeyboard Encoder Example");
+}
+
+void loop() {
+  if (keyboard.update()) {
+    Serial.print("User entered: ");
+    Serial.println(keyboard.getInputText());
+    
+    keyboard.reset();
+  }
+  
+  delay(10);
+}
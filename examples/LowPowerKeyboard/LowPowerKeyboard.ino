@@ -0,0 +1,92 @@
+/*
+  LowPowerKeyboard Example
+  
+  This example sleeps the CPU between keyboard updates instead of calling
+  update() in a tight loop. The keyboard reports how long it can wait
+  (cursor blink, held buttons, password reveal, idle timeout) and the
+  buttons end the sleep early.
+  
+  On ESP32 light sleep is used, woken by a timer or a button. Other boards
+  fall back to a short delay() unless a sleep mode is added for them.
+  
+  Hardware Requirements:
+  - ESP32 (or any Arduino compatible board)
+  - SSD1306 OLED Display (128x64) - I2C
+  - 3 Push buttons (UP, DOWN, SELECT)
+  
+  Connections:
+  - OLED SDA -> GPIO 21
+  - OLED SCL -> GPIO 22
+  - UP Button -> GPIO 25
+  - DOWN Button -> GPIO 26
+  - SELECT Button -> GPIO 27
+  
+  Created by Sk Raihan, SKR Electronics Lab
+  https://github.com/skr-electronics-lab
+*/
+
+#include <U8g2lib.h>
+#include <OLEDKeyboard.h>
+
+// Initialize display
+U8G2_SSD1306_128X64_NONAME_F_HW_I2C u8g2(U8G2_R0, /* reset=*/ U8X8_PIN_NONE);
+
+// Pin definitions
+#define UP_PIN 25
+#define DOWN_PIN 26
+#define SELECT_PIN 27
+
+// Initialize keyboard
+OLEDKeyboard keyboard(&u8g2, UP_PIN, DOWN_PIN, SELECT_PIN);
+
+void setup() {
+  Serial.begin(115200);
+  
+  // Initialize display
+  u8g2.begin();
+  
+  // Initialize keyboard, powering the display down after 30 s
+  keyboard.begin();
+  keyboard.setIdleTimeout(30000);
+  keyboard.attachInterrupts();
+  
+#if defined(ESP32)
+  // Any button pulled low wakes the CPU from light sleep
+  gpio_wakeup_enable((gpio_num_t)UP_PIN, GPIO_INTR_LOW_LEVEL);
+  gpio_wakeup_enable((gpio_num_t)DOWN_PIN, GPIO_INTR_LOW_LEVEL);
+  gpio_wakeup_enable((gpio_num_t)SELECT_PIN, GPIO_INTR_LOW_LEVEL);
+  esp_sleep_enable_gpio_wakeup();
+#endif
+  
+  Serial.println("OLEDKeyboard Low Power Example");
+}
+
+void loop() {
+  if (keyboard.update()) {
+    Serial.print("User entered: ");
+    Serial.println(keyboard.getInputText());
+    
+    keyboard.reset();
+  }
+  
+  sleepFor(keyboard.nextDeadlineMs());
+}
+
+void sleepFor(unsigned long ms) {
+  if (ms == 0) {
+    return;
+  }
+  
+#if defined(ESP32)
+  Serial.flush();
+  if (ms == OLEDKeyboard::NO_DEADLINE) {
+    // Idle: only a button can wake us
+    esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_TIMER);
+  } else {
+    esp_sleep_enable_timer_wakeup(ms * 1000ULL);
+  }
+  esp_light_sleep_start();
+#else
+  delay(ms < 10 ? ms : 10);
+#endif
+}
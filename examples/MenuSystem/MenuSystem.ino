@@ -105,6 +105,7 @@ int inputType = 0; // 0 = username, 1 = device name
 // EEPROM addresses
 const int EEPROM_SIZE = 512;
 const int SETTINGS_ADDRESS = 0;
+const int USAGE_ADDRESS = 64;
 
 void setup() {
   Serial.begin(115200);
@@ -118,14 +119,16 @@ void setup() {
   // Initialize keyboard
   keyboard.begin();
   keyboard.setMaxLength(20);
+  keyboard.setFrequentLayer(true);  // Most used keys closest to the start
   
   // Initialize buttons
   pinMode(UP_PIN, INPUT_PULLUP);
   pinMode(DOWN_PIN, INPUT_PULLUP);
   pinMode(SELECT_PIN, INPUT_PULLUP);
   
-  // Load settings from EEPROM
+  // Load settings and keyboard usage from EEPROM
   loadSettings();
+  loadKeyboardUsage();
   
   Serial.println("Menu System with OLEDKeyboard");
   Serial.println("Navigate with UP/DOWN, SELECT to choose");
@@ -268,11 +271,13 @@ void executeSettingsOption() {
   switch (selectedSettingsMenu) {
     case SETTINGS_USERNAME:
       inputType = 0;
+      keyboard.setInputProfile(PROFILE_TEXT);
       startTextInput("Enter Username:", settings.username);
       break;
       
     case SETTINGS_DEVICE_NAME:
       inputType = 1;
+      keyboard.setInputProfile(PROFILE_HOSTNAME);  // Letters, digits and '-' only
       startTextInput("Enter Device Name:", settings.deviceName);
       break;
       
@@ -323,6 +328,7 @@ void handleTextInput() {
       
       settings.initialized = true;
       saveSettings();
+      saveKeyboardUsage();
       
       // Show confirmation
       u8g2.clearBuffer();
@@ -440,4 +446,23 @@ void saveSettings() {
   EEPROM.commit();
   
   Serial.println("Settings saved");
+}
+
+void loadKeyboardUsage() {
+  uint8_t usage[OLEDKeyboard::USAGE_DATA_SIZE];
+  for (size_t i = 0; i < sizeof(usage); i++) {
+    usage[i] = EEPROM.read(USAGE_ADDRESS + i);
+  }
+  
+  // Ignored if nothing valid has been saved yet
+  keyboard.loadUsage(usage, sizeof(usage));
+}
+
+void saveKeyboardUsage() {
+  uint8_t usage[OLEDKeyboard::USAGE_DATA_SIZE];
+  size_t size = keyboard.saveUsage(usage, sizeof(usage));
+  for (size_t i = 0; i < size; i++) {
+    EEPROM.write(USAGE_ADDRESS + i, usage[i]);
+  }
+  EEPROM.commit();
 }
\ No newline at end of file
@@ -0,0 +1,112 @@
+/*
+  ReplaySession Example
+  
+  This example records every key event of a typing session into RAM.
+  When the input is complete, the log is printed over Serial (to attach
+  to a bug report) and replayed at full speed on a second, headless
+  keyboard. The replay reports how many events it processed per second
+  and whether the keyboard state ever differed from the recording.
+  
+  Hardware Requirements:
+  - ESP32/ESP8266 or Arduino compatible board
+  - SSD1306 OLED Display (128x64) - I2C
+  - 3 Push buttons (UP, DOWN, SELECT)
+  
+  Connections:
+  - OLED SDA -> GPIO 21 (ESP32) or D2 (ESP8266)
+  - OLED SCL -> GPIO 22 (ESP32) or D1 (ESP8266)
+  - UP Button -> GPIO 2
+  - DOWN Button -> GPIO 3
+  - SELECT Button -> GPIO 4
+  
+  Created by Sk Raihan, SKR Electronics Lab
+  https://github.com/skr-electronics-lab
+*/
+
+#include <U8g2lib.h>
+#include <OLEDKeyboard.h>
+
+// Initialize display, plus a display-less one for the replay
+U8G2_SSD1306_128X64_NONAME_F_HW_I2C u8g2(U8G2_R0, /* reset=*/ U8X8_PIN_NONE);
+U8G2_NULL headless(U8G2_R0);
+
+// Pin definitions
+#define UP_PIN 2
+#define DOWN_PIN 3
+#define SELECT_PIN 4
+
+// Initialize keyboard and recorder (5 bytes per event)
+OLEDKeyboard keyboard(&u8g2, UP_PIN, DOWN_PIN, SELECT_PIN);
+uint8_t sessionLog[600];
+InputRecorder recorder(sessionLog, sizeof(sessionLog));
+
+void setup() {
+  Serial.begin(115200);
+  
+  // Initialize display
+  u8g2.begin();
+  headless.begin();
+  
+  // Initialize keyboard
+  keyboard.begin();
+  keyboard.setObserver(&recorder);
+  
+  Serial.println("OLEDKeyboard Replay Example");
+}
+
+void loop() {
+  if (keyboard.update()) {
+    Serial.print("User entered: ");
+    Serial.println(keyboard.getInputText());
+    
+    printLog();
+    replayLog();
+    
+    keyboard.reset();
+    recorder.clear();
+  }
+  
+  delay(10);
+}
+
+void printLog() {
+  Serial.print("Log (");
+  Serial.print(recorder.size());
+  Serial.println(" bytes):");
+  for (size_t i = 0; i < recorder.size(); i++) {
+    if (recorder.data()[i] < 0x10) {
+      Serial.print('0');
+    }
+    Serial.print(recorder.data()[i], HEX);
+    Serial.print((i % 16 == 15) ? '\n' : ' ');
+  }
+  Serial.println();
+}
+
+void replayLog() {
+  // Same settings as the recorded keyboard, driven by virtual time
+  InputReplay replay(recorder.data(), recorder.size());
+  OLEDKeyboard copy(&headless, &replay);
+  copy.setClock(VirtualClock::now);
+  copy.setObserver(&replay);
+  copy.begin();
+  
+  unsigned long start = micros();
+  while (!replay.isFinished()) {
+    unsigned long wait = copy.nextDeadlineMs();
+    VirtualClock::advance((wait == OLEDKeyboard::NO_DEADLINE) ? 1 : wait);
+    copy.update();
+  }
+  unsigned long elapsed = micros() - start;
+  
+  Serial.print("Replayed ");
+  Serial.print(replay.getEventCount());
+  Serial.print(" events in ");
+  Serial.print(elapsed);
+  Serial.print(" us (");
+  Serial.print(replay.getEventCount() * 1000000.0 / (elapsed > 0 ? elapsed : 1), 0);
+  Serial.print(" events/s), mismatches: ");
+  Serial.println(replay.getMismatches());
+  Serial.print("Replayed text: ");
+  Serial.println(copy.getInputText());
+}
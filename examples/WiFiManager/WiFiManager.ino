@@ -8,7 +8,7 @@
   Features:
   - Scan for available WiFi networks
   - Select network from list
-  - Enter password using on-screen keyboard
+  - Enter password using on-screen keyboard (masked)
   - Connect to selected network
   - Display connection status
   
@@ -74,7 +74,7 @@ MenuOption selectedMenu = MENU_SCAN_WIFI;
 int selectedNetwork = 0;
 int networkCount = 0;
 String selectedSSID = "";
-String wifiPassword = "";
+char wifiPassword[64] = "";  // WPA2 allows up to 63 bytes
 unsigned long lastButtonPress = 0;
 unsigned long stateTimer = 0;
 const unsigned long DEBOUNCE_DELAY = 200;
@@ -88,6 +88,7 @@ void setup() {
   // Initialize keyboard
   keyboard.begin();
   keyboard.setMaxLength(30);  // WiFi passwords can be long
+  keyboard.setMasked(true);
   
   // Initialize buttons
   pinMode(UP_PIN, INPUT_PULLUP);
@@ -262,7 +263,7 @@ void handleNetworkList() {
     
     if (WiFi.encryptionType(selectedNetwork) == WIFI_AUTH_OPEN) {
       // Open network, connect directly
-      wifiPassword = "";
+      wifiPassword[0] = '\0';
       connectToWiFi();
     } else {
       // Secured network, ask for password
@@ -322,7 +323,7 @@ void startPasswordInput() {
 
 void handlePasswordInput() {
   if (keyboard.update()) {
-    wifiPassword = keyboard.getInputText();
+    keyboard.getInputText(wifiPassword, sizeof(wifiPassword));
     connectToWiFi();
   }
 }
@@ -351,7 +352,7 @@ void connectToWiFi() {
   u8g2.drawStr(0, 28, selectedSSID.c_str());
   u8g2.sendBuffer();
   
-  WiFi.begin(selectedSSID.c_str(), wifiPassword.c_str());
+  WiFi.begin(selectedSSID.c_str(), wifiPassword);
   
   Serial.print("Connecting to ");
   Serial.print(selectedSSID);
@@ -0,0 +1,67 @@
+/*
+  WordCompletion Example
+
+  This example demonstrates predictive word completion with OLEDKeyboard.
+  While typing, the best matching word from a dictionary is shown after
+  the text. Press UP from the first key to select a completion and
+  SELECT to insert it.
+
+  The dictionary in dictionary.h was generated from words.txt with:
+    python3 extras/make_dictionary.py --name technicianWords words.txt > dictionary.h
+
+  Hardware Requirements:
+  - ESP32/ESP8266 or Arduino compatible board
+  - SSD1306 OLED Display (128x64) - I2C
+  - 3 Push buttons (UP, DOWN, SELECT)
+
+  Connections:
+  - OLED SDA -> GPIO 21 (ESP32) or D2 (ESP8266)
+  - OLED SCL -> GPIO 22 (ESP32) or D1 (ESP8266)
+  - UP Button -> GPIO 2
+  - DOWN Button -> GPIO 3
+  - SELECT Button -> GPIO 4
+
+  Created by Sk Raihan, SKR Electronics Lab
+  https://github.com/skr-electronics-lab
+*/
+
+#include <U8g2lib.h>
+#include <OLEDKeyboard.h>
+#include "dictionary.h"
+
+// Initialize display
+U8G2_SSD1306_128X64_NONAME_F_HW_I2C u8g2(U8G2_R0, /* reset=*/ U8X8_PIN_NONE);
+
+// Pin definitions
+#define UP_PIN 2
+#define DOWN_PIN 3
+#define SELECT_PIN 4
+
+// Initialize keyboard
+OLEDKeyboard keyboard(&u8g2, UP_PIN, DOWN_PIN, SELECT_PIN);
+
+void setup() {
+  Serial.begin(115200);
+
+  // Initialize display
+  u8g2.begin();
+
+  // Initialize keyboard with the completion dictionary
+  keyboard.begin();
+  keyboard.setMaxLength(30);
+  keyboard.setDictionary(technicianWords);
+
+  Serial.println("OLEDKeyboard Word Completion Example");
+  Serial.println("Press UP from the first key to pick a completion");
+}
+
+void loop() {
+  if (keyboard.update()) {
+    Serial.print("User entered: ");
+    Serial.println(keyboard.getInputText());
+
+    keyboard.reset();
+  }
+
+  delay(10);
+}
@@ -0,0 +1,132 @@
+// Generated by extras/make_dictionary.py - do not edit
+// 30 words, 185 nodes, 1498 bytes
+
+#include <Arduino.h>
+
+const uint8_t technicianWords[] PROGMEM = {
+  0x10, 0x00, 0x61, 0x32, 0x00, 0x62, 0x43, 0x00, 0x63, 0x4A, 0x00, 0x64,
+  0x5E, 0x00, 0x66, 0x67, 0x00, 0x67, 0x6E, 0x00, 0x68, 0x75, 0x00, 0x69,
+  0x7C, 0x00, 0x6E, 0x83, 0x00, 0x6F, 0x8A, 0x00, 0x70, 0x91, 0x00, 0x72,
+  0xA2, 0x00, 0x73, 0xAE, 0x00, 0x74, 0xBC, 0x00, 0x75, 0xC8, 0x00, 0x76,
+  0xCF, 0x00, 0x03, 0x03, 0xF0, 0x04, 0xF6, 0x04, 0xFD, 0x04, 0x63, 0xD6,
+  0x00, 0x64, 0xDD, 0x00, 0x6C, 0xE4, 0x00, 0x01, 0x01, 0x03, 0x05, 0x61,
+  0xEB, 0x00, 0x04, 0x03, 0x0B, 0x05, 0x12, 0x05, 0x1A, 0x05, 0x61, 0xF2,
+  0x00, 0x68, 0xF9, 0x00, 0x6F, 0x00, 0x01, 0x75, 0x07, 0x01, 0x01, 0x02,
+  0x22, 0x05, 0x29, 0x05, 0x65, 0x0E, 0x01, 0x01, 0x01, 0x31, 0x05, 0x69,
+  0x1A, 0x01, 0x01, 0x01, 0x3A, 0x05, 0x61, 0x21, 0x01, 0x01, 0x01, 0x42,
+  0x05, 0x75, 0x28, 0x01, 0x01, 0x01, 0x4B, 0x05, 0x6E, 0x2F, 0x01, 0x01,
+  0x01, 0x54, 0x05, 0x65, 0x36, 0x01, 0x01, 0x01, 0x5C, 0x05, 0x66, 0x3D,
+  0x01, 0x03, 0x03, 0x63, 0x05, 0x6C, 0x05, 0x72, 0x05, 0x61, 0x44, 0x01,
+  0x6F, 0x4B, 0x01, 0x72, 0x52, 0x01, 0x02, 0x02, 0x7B, 0x05, 0x82, 0x05,
+  0x65, 0x59, 0x01, 0x6F, 0x60, 0x01, 0x02, 0x03, 0x88, 0x05, 0x8F, 0x05,
+  0x95, 0x05, 0x65, 0x67, 0x01, 0x74, 0x78, 0x01, 0x02, 0x02, 0x9C, 0x05,
+  0xA8, 0x05, 0x65, 0x81, 0x01, 0x68, 0x88, 0x01, 0x01, 0x01, 0xB2, 0x05,
+  0x70, 0x8F, 0x01, 0x01, 0x01, 0xB9, 0x05, 0x6F, 0x96, 0x01, 0x01, 0x01,
+  0xF6, 0x04, 0x63, 0x9D, 0x01, 0x01, 0x01, 0xF0, 0x04, 0x6D, 0xA4, 0x01,
+  0x01, 0x01, 0xFD, 0x04, 0x61, 0xAB, 0x01, 0x01, 0x01, 0x03, 0x05, 0x74,
+  0xB2, 0x01, 0x01, 0x01, 0xC1, 0x05, 0x6C, 0xB9, 0x01, 0x01, 0x01, 0x12,
+  0x05, 0x61, 0xC0, 0x01, 0x01, 0x01, 0x0B, 0x05, 0x6E, 0xC7, 0x01, 0x01,
+  0x01, 0x1A, 0x05, 0x72, 0xCE, 0x01, 0x02, 0x02, 0x22, 0x05, 0x29, 0x05,
+  0x66, 0xD5, 0x01, 0x76, 0xDC, 0x01, 0x01, 0x01, 0x31, 0x05, 0x72, 0xE3,
+  0x01, 0x01, 0x01, 0x3A, 0x05, 0x74, 0xEA, 0x01, 0x01, 0x01, 0x42, 0x05,
+  0x6D, 0xF1, 0x01, 0x01, 0x01, 0x4B, 0x05, 0x74, 0xF8, 0x01, 0x01, 0x01,
+  0x54, 0x05, 0x74, 0xFF, 0x01, 0x01, 0x01, 0x5C, 0x05, 0x66, 0x06, 0x02,
+  0x01, 0x01, 0x63, 0x05, 0x73, 0x0D, 0x02, 0x01, 0x01, 0x6C, 0x05, 0x69,
+  0x14, 0x02, 0x01, 0x01, 0x72, 0x05, 0x65, 0x1B, 0x02, 0x01, 0x01, 0x82,
+  0x05, 0x73, 0x22, 0x02, 0x01, 0x01, 0x7B, 0x05, 0x75, 0x29, 0x02, 0x03,
+  0x03, 0x88, 0x05, 0x8F, 0x05, 0x95, 0x05, 0x6E, 0x30, 0x02, 0x72, 0x37,
+  0x02, 0x74, 0x3E, 0x02, 0x01, 0x02, 0xCB, 0x05, 0xD2, 0x05, 0x61, 0x45,
+  0x02, 0x01, 0x01, 0x9C, 0x05, 0x6D, 0x4E, 0x02, 0x01, 0x01, 0xA8, 0x05,
+  0x72, 0x55, 0x02, 0x01, 0x01, 0xB2, 0x05, 0x64, 0x5C, 0x02, 0x01, 0x01,
+  0xB9, 0x05, 0x6C, 0x63, 0x02, 0x01, 0x01, 0xF6, 0x04, 0x65, 0x6A, 0x02,
+  0x01, 0x01, 0xF0, 0x04, 0x69, 0x71, 0x02, 0x01, 0x01, 0xFD, 0x04, 0x72,
+  0x78, 0x02, 0x01, 0x01, 0x03, 0x05, 0x74, 0x7F, 0x02, 0x01, 0x01, 0xC1,
+  0x05, 0x69, 0x86, 0x02, 0x01, 0x01, 0x12, 0x05, 0x6E, 0x8D, 0x02, 0x01,
+  0x01, 0x0B, 0x05, 0x66, 0x94, 0x02, 0x01, 0x01, 0x1A, 0x05, 0x72, 0x9B,
+  0x02, 0x01, 0x01, 0x29, 0x05, 0x61, 0xA2, 0x02, 0x01, 0x01, 0x22, 0x05,
+  0x69, 0xA9, 0x02, 0x01, 0x01, 0x31, 0x05, 0x6D, 0xB0, 0x02, 0x01, 0x01,
+  0x3A, 0x05, 0x65, 0xB7, 0x02, 0x01, 0x01, 0x42, 0x05, 0x69, 0xBE, 0x02,
+  0x01, 0x01, 0x4B, 0x05, 0x65, 0xC5, 0x02, 0x01, 0x01, 0x54, 0x05, 0x77,
+  0xCC, 0x02, 0x01, 0x01, 0x5C, 0x05, 0x73, 0xD3, 0x02, 0x01, 0x01, 0x63,
+  0x05, 0x73, 0xDA, 0x02, 0x01, 0x01, 0x6C, 0x05, 0x6E, 0xE1, 0x02, 0x01,
+  0x01, 0x72, 0x05, 0x73, 0xE8, 0x02, 0x01, 0x01, 0x82, 0x05, 0x65, 0xEF,
+  0x02, 0x01, 0x01, 0x7B, 0x05, 0x74, 0xF6, 0x02, 0x01, 0x01, 0x88, 0x05,
+  0x73, 0xFD, 0x02, 0x01, 0x01, 0x95, 0x05, 0x76, 0x04, 0x03, 0x01, 0x01,
+  0x8F, 0x05, 0x75, 0x0B, 0x03, 0x01, 0x02, 0xCB, 0x05, 0xD2, 0x05, 0x74,
+  0x12, 0x03, 0x01, 0x01, 0x9C, 0x05, 0x70, 0x1E, 0x03, 0x01, 0x01, 0xA8,
+  0x05, 0x65, 0x25, 0x03, 0x01, 0x01, 0xB2, 0x05, 0x61, 0x2C, 0x03, 0x01,
+  0x01, 0xB9, 0x05, 0x74, 0x33, 0x03, 0x01, 0x01, 0xF6, 0x04, 0x73, 0x3A,
+  0x03, 0x01, 0x01, 0xF0, 0x04, 0x6E, 0x41, 0x03, 0x01, 0x01, 0xFD, 0x04,
+  0x6D, 0x43, 0x03, 0x01, 0x01, 0x03, 0x05, 0x65, 0x45, 0x03, 0x01, 0x01,
+  0xC1, 0x05, 0x62, 0x4C, 0x03, 0x01, 0x01, 0x12, 0x05, 0x6E, 0x53, 0x03,
+  0x01, 0x01, 0x0B, 0x05, 0x69, 0x5A, 0x03, 0x01, 0x01, 0x1A, 0x05, 0x65,
+  0x61, 0x03, 0x01, 0x01, 0x29, 0x05, 0x75, 0x68, 0x03, 0x01, 0x01, 0x22,
+  0x05, 0x63, 0x6F, 0x03, 0x01, 0x01, 0x31, 0x05, 0x77, 0x76, 0x03, 0x01,
+  0x01, 0x3A, 0x05, 0x77, 0x7D, 0x03, 0x01, 0x01, 0x42, 0x05, 0x64, 0x84,
+  0x03, 0x01, 0x01, 0x4B, 0x05, 0x72, 0x8B, 0x03, 0x01, 0x01, 0x54, 0x05,
+  0x6F, 0x92, 0x03, 0x01, 0x01, 0x5C, 0x05, 0x65, 0x99, 0x03, 0x01, 0x01,
+  0x63, 0x05, 0x77, 0xA0, 0x03, 0x01, 0x01, 0x6C, 0x05, 0x74, 0xA7, 0x03,
+  0x01, 0x01, 0x72, 0x05, 0x73, 0xA9, 0x03, 0x01, 0x01, 0x82, 0x05, 0x74,
+  0xB0, 0x03, 0x01, 0x01, 0x7B, 0x05, 0x65, 0xB2, 0x03, 0x01, 0x01, 0x88,
+  0x05, 0x6F, 0xB9, 0x03, 0x01, 0x01, 0x95, 0x05, 0x65, 0xC0, 0x03, 0x01,
+  0x01, 0x8F, 0x05, 0x70, 0xC7, 0x03, 0x02, 0x02, 0xCB, 0x05, 0xD2, 0x05,
+  0x69, 0xC9, 0x03, 0x75, 0xD0, 0x03, 0x01, 0x01, 0x9C, 0x05, 0x65, 0xD7,
+  0x03, 0x01, 0x01, 0xA8, 0x05, 0x73, 0xDE, 0x03, 0x01, 0x01, 0xB2, 0x05,
+  0x74, 0xE5, 0x03, 0x01, 0x01, 0xB9, 0x05, 0x61, 0xEC, 0x03, 0x01, 0x01,
+  0xF6, 0x04, 0x73, 0xF3, 0x03, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x03,
+  0x05, 0x72, 0xF5, 0x03, 0x01, 0x01, 0xC1, 0x05, 0x72, 0xFC, 0x03, 0x01,
+  0x01, 0x12, 0x05, 0x65, 0x03, 0x04, 0x01, 0x01, 0x0B, 0x05, 0x67, 0x0A,
+  0x04, 0x01, 0x01, 0x1A, 0x05, 0x6E, 0x0C, 0x04, 0x01, 0x01, 0x29, 0x05,
+  0x6C, 0x13, 0x04, 0x01, 0x01, 0x22, 0x05, 0x65, 0x1A, 0x04, 0x01, 0x01,
+  0x31, 0x05, 0x61, 0x1C, 0x04, 0x01, 0x01, 0x3A, 0x05, 0x61, 0x23, 0x04,
+  0x01, 0x01, 0x42, 0x05, 0x69, 0x2A, 0x04, 0x01, 0x01, 0x4B, 0x05, 0x76,
+  0x31, 0x04, 0x01, 0x01, 0x54, 0x05, 0x72, 0x38, 0x04, 0x01, 0x01, 0x5C,
+  0x05, 0x74, 0x3F, 0x04, 0x01, 0x01, 0x63, 0x05, 0x6F, 0x41, 0x04, 0x00,
+  0x00, 0x01, 0x01, 0x72, 0x05, 0x75, 0x48, 0x04, 0x00, 0x00, 0x01, 0x01,
+  0x7B, 0x05, 0x72, 0x4F, 0x04, 0x01, 0x01, 0x88, 0x05, 0x72, 0x51, 0x04,
+  0x01, 0x01, 0x95, 0x05, 0x72, 0x53, 0x04, 0x00, 0x00, 0x01, 0x01, 0xD2,
+  0x05, 0x6F, 0x55, 0x04, 0x01, 0x01, 0xCB, 0x05, 0x73, 0x5C, 0x04, 0x01,
+  0x01, 0x9C, 0x05, 0x72, 0x5E, 0x04, 0x01, 0x01, 0xA8, 0x05, 0x68, 0x65,
+  0x04, 0x01, 0x01, 0xB2, 0x05, 0x65, 0x6C, 0x04, 0x01, 0x01, 0xB9, 0x05,
+  0x67, 0x6E, 0x04, 0x00, 0x00, 0x01, 0x01, 0x03, 0x05, 0x79, 0x75, 0x04,
+  0x01, 0x01, 0xC1, 0x05, 0x61, 0x77, 0x04, 0x01, 0x01, 0x12, 0x05, 0x6C,
+  0x7E, 0x04, 0x00, 0x00, 0x01, 0x01, 0x1A, 0x05, 0x74, 0x80, 0x04, 0x01,
+  0x01, 0x29, 0x05, 0x74, 0x82, 0x04, 0x00, 0x00, 0x01, 0x01, 0x31, 0x05,
+  0x72, 0x84, 0x04, 0x01, 0x01, 0x3A, 0x05, 0x79, 0x8B, 0x04, 0x01, 0x01,
+  0x42, 0x05, 0x74, 0x8D, 0x04, 0x01, 0x01, 0x4B, 0x05, 0x61, 0x94, 0x04,
+  0x01, 0x01, 0x54, 0x05, 0x6B, 0x9B, 0x04, 0x00, 0x00, 0x01, 0x01, 0x63,
+  0x05, 0x72, 0x9D, 0x04, 0x01, 0x01, 0x72, 0x05, 0x72, 0xA4, 0x04, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0xD2, 0x05, 0x6E, 0xAB, 0x04,
+  0x00, 0x00, 0x01, 0x01, 0x9C, 0x05, 0x61, 0xAD, 0x04, 0x01, 0x01, 0xA8,
+  0x05, 0x6F, 0xB4, 0x04, 0x00, 0x00, 0x01, 0x01, 0xB9, 0x05, 0x65, 0xBB,
+  0x04, 0x00, 0x00, 0x01, 0x01, 0xC1, 0x05, 0x74, 0xBD, 0x04, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x31, 0x05, 0x65, 0xC4, 0x04, 0x00,
+  0x00, 0x01, 0x01, 0x42, 0x05, 0x79, 0xC6, 0x04, 0x01, 0x01, 0x4B, 0x05,
+  0x6C, 0xC8, 0x04, 0x00, 0x00, 0x01, 0x01, 0x63, 0x05, 0x64, 0xCA, 0x04,
+  0x01, 0x01, 0x72, 0x05, 0x65, 0xCC, 0x04, 0x00, 0x00, 0x01, 0x01, 0x9C,
+  0x05, 0x74, 0xCE, 0x04, 0x01, 0x01, 0xA8, 0x05, 0x6C, 0xD5, 0x04, 0x00,
+  0x00, 0x01, 0x01, 0xC1, 0x05, 0x65, 0xDC, 0x04, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x9C, 0x05, 0x75, 0xDE,
+  0x04, 0x01, 0x01, 0xA8, 0x05, 0x64, 0xE5, 0x04, 0x00, 0x00, 0x01, 0x01,
+  0x9C, 0x05, 0x72, 0xE7, 0x04, 0x00, 0x00, 0x01, 0x01, 0x9C, 0x05, 0x65,
+  0xEE, 0x04, 0x00, 0x00, 0x61, 0x64, 0x6D, 0x69, 0x6E, 0x00, 0x61, 0x63,
+  0x63, 0x65, 0x73, 0x73, 0x00, 0x61, 0x6C, 0x61, 0x72, 0x6D, 0x00, 0x62,
+  0x61, 0x74, 0x74, 0x65, 0x72, 0x79, 0x00, 0x63, 0x6F, 0x6E, 0x66, 0x69,
+  0x67, 0x00, 0x63, 0x68, 0x61, 0x6E, 0x6E, 0x65, 0x6C, 0x00, 0x63, 0x75,
+  0x72, 0x72, 0x65, 0x6E, 0x74, 0x00, 0x64, 0x65, 0x76, 0x69, 0x63, 0x65,
+  0x00, 0x64, 0x65, 0x66, 0x61, 0x75, 0x6C, 0x74, 0x00, 0x66, 0x69, 0x72,
+  0x6D, 0x77, 0x61, 0x72, 0x65, 0x00, 0x67, 0x61, 0x74, 0x65, 0x77, 0x61,
+  0x79, 0x00, 0x68, 0x75, 0x6D, 0x69, 0x64, 0x69, 0x74, 0x79, 0x00, 0x69,
+  0x6E, 0x74, 0x65, 0x72, 0x76, 0x61, 0x6C, 0x00, 0x6E, 0x65, 0x74, 0x77,
+  0x6F, 0x72, 0x6B, 0x00, 0x6F, 0x66, 0x66, 0x73, 0x65, 0x74, 0x00, 0x70,
+  0x61, 0x73, 0x73, 0x77, 0x6F, 0x72, 0x64, 0x00, 0x70, 0x6F, 0x69, 0x6E,
+  0x74, 0x00, 0x70, 0x72, 0x65, 0x73, 0x73, 0x75, 0x72, 0x65, 0x00, 0x72,
+  0x6F, 0x75, 0x74, 0x65, 0x72, 0x00, 0x72, 0x65, 0x73, 0x65, 0x74, 0x00,
+  0x73, 0x65, 0x6E, 0x73, 0x6F, 0x72, 0x00, 0x73, 0x65, 0x74, 0x75, 0x70,
+  0x00, 0x73, 0x65, 0x72, 0x76, 0x65, 0x72, 0x00, 0x74, 0x65, 0x6D, 0x70,
+  0x65, 0x72, 0x61, 0x74, 0x75, 0x72, 0x65, 0x00, 0x74, 0x68, 0x72, 0x65,
+  0x73, 0x68, 0x6F, 0x6C, 0x64, 0x00, 0x75, 0x70, 0x64, 0x61, 0x74, 0x65,
+  0x00, 0x76, 0x6F, 0x6C, 0x74, 0x61, 0x67, 0x65, 0x00, 0x63, 0x61, 0x6C,
+  0x69, 0x62, 0x72, 0x61, 0x74, 0x65, 0x00, 0x73, 0x74, 0x61, 0x74, 0x75,
+  0x73, 0x00, 0x73, 0x74, 0x61, 0x74, 0x69, 0x6F, 0x6E, 0x00,
+};
@@ -0,0 +1,184 @@
+#!/usr/bin/env python3
+"""
+footprint.py - Measure the flash and RAM used by OLEDKeyboard
+
+Compiles an example for several boards and feature configurations with
+arduino-cli and prints a table of flash, static RAM and
+sizeof(OLEDKeyboard). The library is taken from this checkout.
+
+Usage:
+  python3 footprint.py
+  python3 footprint.py --boards uno esp32 --configs default minimal
+  python3 footprint.py --example WordCompletion --markdown
+  python3 footprint.py --compare HEAD~1
+
+Requires arduino-cli with the U8g2 library and the cores of the chosen
+boards installed, e.g.:
+  arduino-cli core install arduino:avr esp8266:esp8266 esp32:esp32
+  arduino-cli lib install U8g2
+
+Configurations are passed as compiler.cpp.extra_flags, so the defines
+reach the library and the sketch alike. Flash and RAM are the totals
+arduino-cli reports for the sketch (U8g2 and the core included), so
+compare rows rather than reading them as the keyboard's share. A build
+that does not fit the board is listed with its error. --compare adds
+sizeof(OLEDKeyboard) at another git revision, to see what a change to
+the object layout saves.
+"""
+
+import argparse
+import io
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tarfile
+import tempfile
+
+BOARDS = {
+    "uno": "arduino:avr:uno",
+    "esp8266": "esp8266:esp8266:nodemcuv2",
+    "esp32": "esp32:esp32:esp32",
+}
+
+CONFIGS = {
+    "default": [],
+    "no-symbols": ["OLEDKEYBOARD_SYMBOLS=0"],
+    "no-blink": ["OLEDKEYBOARD_CURSOR_BLINK=0"],
+    "no-scrolling": ["OLEDKEYBOARD_SCROLLING=0"],
+    "minimal": ["OLEDKEYBOARD_SYMBOLS=0", "OLEDKEYBOARD_CURSOR_BLINK=0",
+                "OLEDKEYBOARD_SCROLLING=0", "OLEDKEYBOARD_MAX_LENGTH=32",
+                "OLEDKEYBOARD_UNDO_DEPTH=4", "OLEDKEYBOARD_HISTORY_SIZE=32"],
+    "profile": ["OLEDKEYBOARD_PROFILE=1"],
+}
+
+# Instantiating an undefined template puts the size into the error message
+SIZE_PROBE = """#include <OLEDKeyboard.h>
+template <unsigned N> struct OLEDKeyboardSize;
+OLEDKeyboardSize<sizeof(OLEDKeyboard)> probe;
+void setup() {}
+void loop() {}
+"""
+
+FLASH_RE = re.compile(r"Sketch uses (\d+) bytes")
+RAM_RE = re.compile(r"Global variables use (\d+) bytes")
+SIZE_RE = re.compile(r"OLEDKeyboardSize<(\d+)u?>")
+
+
+def compile_sketch(cli, fqbn, sketch, library, defines):
+    flags = " ".join("-D" + d for d in defines)
+    command = [cli, "compile", "--fqbn", fqbn, "--library", library,
+               "--build-property", "compiler.cpp.extra_flags=" + flags, sketch]
+    result = subprocess.run(command, stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                            universal_newlines=True)
+    return result.returncode == 0, result.stdout
+
+
+def first_error(output):
+    for line in output.splitlines():
+        if "error" in line.lower():
+            return line.strip()
+    return "compile failed"
+
+
+def probe_size(cli, fqbn, probe, library, defines):
+    # The probe is expected to fail; only the size in the message matters
+    ok, output = compile_sketch(cli, fqbn, probe, library, defines)
+    size = SIZE_RE.search(output)
+    return int(size.group(1)) if size else None
+
+
+def measure(cli, fqbn, sketch, probe, library, defines, baseline):
+    row = {"flash": None, "ram": None, "size": None, "baseline": None, "error": None}
+    ok, output = compile_sketch(cli, fqbn, sketch, library, defines)
+    flash = FLASH_RE.search(output)
+    ram = RAM_RE.search(output)
+    if flash:
+        row["flash"] = int(flash.group(1))
+    if ram:
+        row["ram"] = int(ram.group(1))
+    if not ok:
+        row["error"] = first_error(output)
+
+    row["size"] = probe_size(cli, fqbn, probe, library, defines)
+    if baseline is not None:
+        row["baseline"] = probe_size(cli, fqbn, probe, baseline, defines)
+    return row
+
+
+def export_revision(library, revision, path):
+    archive = subprocess.run(["git", "-C", library, "archive", "--format=tar", revision],
+                             stdout=subprocess.PIPE, check=True).stdout
+    with tarfile.open(fileobj=io.BytesIO(archive)) as tar:
+        tar.extractall(path)
+
+
+def write_table(out, rows, markdown, revision):
+    def value(number):
+        return str(number) if number is not None else "-"
+
+    header = ["board", "config", "flash", "ram", "sizeof"]
+    if revision:
+        header.append("sizeof@" + revision)
+    header.append("note")
+    cells = []
+    for board, config, row in rows:
+        line = [board, config, value(row["flash"]), value(row["ram"]), value(row["size"])]
+        if revision:
+            line.append(value(row["baseline"]))
+        line.append(row["error"] or "")
+        cells.append(line)
+    if markdown:
+        out.write("| " + " | ".join(header) + " |\n")
+        out.write("|" + "---|" * len(header) + "\n")
+        for line in cells:
+            out.write("| " + " | ".join(line) + " |\n")
+        return
+
+    widths = [max(len(line[i]) for line in [header] + cells) for i in range(len(header))]
+    for line in [header] + cells:
+        out.write("  ".join(cell.ljust(width) for cell, width in zip(line, widths)).rstrip() + "\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[1])
+    parser.add_argument("--boards", nargs="+", choices=sorted(BOARDS), default=["uno", "esp8266", "esp32"])
+    parser.add_argument("--configs", nargs="+", choices=sorted(CONFIGS), default=list(CONFIGS))
+    parser.add_argument("--example", default="BasicKeyboard", help="example sketch to compile")
+    parser.add_argument("--cli", default="arduino-cli", help="arduino-cli executable")
+    parser.add_argument("--compare", metavar="REV", help="also measure sizeof at this git revision")
+    parser.add_argument("--markdown", action="store_true", help="print a Markdown table")
+    args = parser.parse_args()
+
+    if shutil.which(args.cli) is None:
+        sys.exit("%s not found" % args.cli)
+
+    library = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    sketch = os.path.join(library, "examples", args.example)
+    if not os.path.isdir(sketch):
+        sys.exit("no example named %s" % args.example)
+
+    with tempfile.TemporaryDirectory() as temp:
+        probe = os.path.join(temp, "SizeProbe")
+        os.mkdir(probe)
+        with open(os.path.join(probe, "SizeProbe.ino"), "w") as f:
+            f.write(SIZE_PROBE)
+
+        baseline = None
+        if args.compare:
+            baseline = os.path.join(temp, "OLEDKeyboard")
+            export_revision(library, args.compare, baseline)
+
+        rows = []
+        for board in args.boards:
+            for config in args.configs:
+                sys.stderr.write("%s %s...\n" % (board, config))
+                row = measure(args.cli, BOARDS[board], sketch, probe, library, CONFIGS[config], baseline)
+                rows.append((board, config, row))
+
+    write_table(sys.stdout, rows, args.markdown, args.compare)
+
+
+if __name__ == "__main__":
+    main()
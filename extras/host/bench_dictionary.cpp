@@ -0,0 +1,96 @@
+/*
+  bench_dictionary.cpp - Cost of the word completion lookup
+  
+  Types each word of a word list on a headless keyboard and times
+  setDictionary(), which walks the trie along the word before the cursor
+  from the root, one step per character: the step a typed character
+  costs, and a backspace costs once per character of the word. An empty
+  word gives the fixed part of the call, which is subtracted.
+  
+  The Makefile builds dictionary.h with extras/make_dictionary.py from
+  WORDS, the WordCompletion example's list by default:
+    make -B bench_dictionary WORDS=mywords.txt && ./bench_dictionary mywords.txt
+*/
+
+#include "host.h"
+#include "dictionary.h"
+
+static const long REPEAT = 20000;
+
+// Key of a lowercase letter on the built-in lowercase layer
+static int letterKey(char c) {
+  return (c == 'y') ? 29 : (c == 'z') ? 30 : c - 'a';
+}
+
+static void press(OLEDKeyboard& keyboard, HostInput& input, InputEvent event, int count = 1) {
+  for (int i = 0; i < count; i++) {
+    input.press(event);
+    keyboard.poll();
+  }
+}
+
+// Nanoseconds per setDictionary() call on the current text
+static double timeWalk(OLEDKeyboard& keyboard) {
+  double start = hostSeconds();
+  for (long i = 0; i < REPEAT; i++) {
+    keyboard.setDictionary(benchWords);
+  }
+  return (hostSeconds() - start) * 1e9 / REPEAT;
+}
+
+int main(int argc, char** argv) {
+  const char* path = (argc > 1) ? argv[1] : "../../examples/WordCompletion/words.txt";
+  std::vector<std::string> lines;
+  if (!loadLines(path, lines)) {
+    return 1;
+  }
+  
+  U8G2_NULL display(U8G2_R0);
+  HostInput input;
+  OLEDKeyboard keyboard(&display, &input);
+  keyboard.setClock(VirtualClock::now);
+  keyboard.setMaxLength(OLEDKEYBOARD_MAX_LENGTH);
+  keyboard.begin();
+  
+  // Shift to the lowercase layer; the selection then stays on the keys
+  // (moving between them never passes the suggestions after the last)
+  static const int SHIFT_KEY = 24;
+  press(keyboard, input, EVENT_DOWN, SHIFT_KEY);
+  press(keyboard, input, EVENT_SELECT);
+  int selection = SHIFT_KEY;
+  
+  timeWalk(keyboard);
+  double empty = timeWalk(keyboard);
+  double total = 0;
+  unsigned long characters = 0;
+  for (size_t i = 0; i < lines.size(); i++) {
+    std::string word = lines[i].substr(0, lines[i].find(' '));
+    for (size_t c = 0; c < word.size(); c++) {
+      if (word[c] < 'a' || word[c] > 'z') {
+        fprintf(stderr, "only lowercase words are typed: %s\n", word.c_str());
+        return 1;
+      }
+      int key = letterKey(word[c]);
+      press(keyboard, input, (key > selection) ? EVENT_DOWN : EVENT_UP, abs(key - selection));
+      press(keyboard, input, EVENT_SELECT);
+      selection = key;
+    }
+    char typed[OLEDKEYBOARD_MAX_LENGTH + 1];
+    keyboard.getInputText(typed, sizeof(typed));
+    if (word != typed) {
+      fprintf(stderr, "typed \"%s\" instead of \"%s\"\n", typed, word.c_str());
+      return 1;
+    }
+    
+    total += timeWalk(keyboard) - empty;
+    characters += word.size();
+    press(keyboard, input, EVENT_BACK, word.size());
+  }
+  
+  double step = total / characters;
+  printf("dictionary: %lu words, %lu bytes, %.1f characters per word\n", (unsigned long)lines.size(),
+         (unsigned long)sizeof(benchWords), (double)characters / lines.size());
+  printf("lookup: %.1f ns per typed character, %.1f ns to re-walk a word after backspace\n",
+         step, total / lines.size());
+  return 0;
+}
@@ -0,0 +1,81 @@
+/*
+  bench_layout.cpp - Navigation distance on the usage-ordered layer
+  
+  Replays hex-style entries (hostnames.txt by default) and reports the
+  average number of UP/DOWN presses per character on the alphabetical
+  layers and on the usage-ordered layer of setFrequentLayer(): before
+  any usage, after one pass over the entries, and on a new keyboard
+  given the first one's saveUsage() data, as after a power cycle.
+  
+  Usage: ./bench_layout [hostnames.txt]
+*/
+
+#include "host.h"
+
+static bool replay(Typist& typist, const std::vector<std::string>& corpus) {
+  typist.resetCounts();
+  for (size_t i = 0; i < corpus.size(); i++) {
+    if (!typist.enter(corpus[i].c_str())) {
+      fprintf(stderr, "could not type \"%s\"\n", corpus[i].c_str());
+      return false;
+    }
+  }
+  return true;
+}
+
+static void report(const char* layout, const Typist& typist) {
+  printf("%-18s  %10.2f  %12.2f\n", layout,
+         (double)typist.moves / typist.characters, (double)typist.presses / typist.characters);
+}
+
+int main(int argc, char** argv) {
+  std::vector<std::string> corpus;
+  if (!loadLines(argc > 1 ? argv[1] : "hostnames.txt", corpus)) {
+    return 1;
+  }
+  
+  printf("layout              moves/char  presses/char\n");
+  U8G2_NULL display(U8G2_R0);
+  HostInput input;
+  uint8_t usage[OLEDKeyboard::USAGE_DATA_SIZE];
+  
+  {
+    OLEDKeyboard keyboard(&display, &input);
+    keyboard.setClock(VirtualClock::now);
+    keyboard.setMaxLength(OLEDKEYBOARD_MAX_LENGTH);
+    keyboard.begin();
+    Typist typist(keyboard, input, display);
+    if (!replay(typist, corpus)) {
+      return 1;
+    }
+    report("alphabetical", typist);
+    
+    keyboard.setFrequentLayer(true);
+    if (!replay(typist, corpus)) {
+      return 1;
+    }
+    report("frequent, new", typist);
+    if (!replay(typist, corpus)) {
+      return 1;
+    }
+    report("frequent, learned", typist);
+    keyboard.saveUsage(usage, sizeof(usage));
+  }
+  
+  OLEDKeyboard keyboard(&display, &input);
+  keyboard.setClock(VirtualClock::now);
+  keyboard.setMaxLength(OLEDKEYBOARD_MAX_LENGTH);
+  keyboard.setFrequentLayer(true);
+  if (!keyboard.loadUsage(usage, sizeof(usage))) {
+    fprintf(stderr, "usage data not accepted\n");
+    return 1;
+  }
+  keyboard.begin();
+  Typist typist(keyboard, input, display);
+  if (!replay(typist, corpus)) {
+    return 1;
+  }
+  report("frequent, restored", typist);
+  printf("%lu characters in %lu entries\n", typist.characters, (unsigned long)corpus.size());
+  return 0;
+}
@@ -0,0 +1,59 @@
+/*
+  bench_prediction.cpp - Presses per character with next-key prediction
+  
+  Replays a corpus (corpus.txt by default, one entry per line) on a
+  headless keyboard with each setKeyPrediction() mode and reports the
+  button presses per character, counting navigation, layer switches,
+  the selects and the final enter. PREDICT_LEARNED is measured on a
+  second pass, after the first one taught it the corpus.
+  
+  Usage: ./bench_prediction [corpus.txt]
+*/
+
+#include "host.h"
+
+static bool replay(Typist& typist, const std::vector<std::string>& corpus) {
+  typist.resetCounts();
+  for (size_t i = 0; i < corpus.size(); i++) {
+    if (!typist.enter(corpus[i].c_str())) {
+      fprintf(stderr, "could not type \"%s\"\n", corpus[i].c_str());
+      return false;
+    }
+  }
+  return true;
+}
+
+int main(int argc, char** argv) {
+  std::vector<std::string> corpus;
+  if (!loadLines(argc > 1 ? argv[1] : "corpus.txt", corpus)) {
+    return 1;
+  }
+  
+  static const KeyPrediction modes[] = {PREDICT_OFF, PREDICT_STATIC, PREDICT_LEARNED};
+  static const char* const names[] = {"off", "static", "learned"};
+  
+  unsigned long characters = 0;
+  printf("prediction  presses/char  moves/char\n");
+  for (int i = 0; i < 3; i++) {
+    U8G2_NULL display(U8G2_R0);
+    HostInput input;
+    OLEDKeyboard keyboard(&display, &input);
+    keyboard.setClock(VirtualClock::now);
+    keyboard.setMaxLength(OLEDKEYBOARD_MAX_LENGTH);
+    keyboard.setKeyPrediction(modes[i]);
+    keyboard.begin();
+    Typist typist(keyboard, input, display);
+    
+    if (modes[i] == PREDICT_LEARNED && !replay(typist, corpus)) {
+      return 1;
+    }
+    if (!replay(typist, corpus)) {
+      return 1;
+    }
+    printf("%-10s  %12.2f  %10.2f\n", names[i],
+           (double)typist.presses / typist.characters, (double)typist.moves / typist.characters);
+    characters = typist.characters;
+  }
+  printf("%lu characters in %lu entries\n", characters, (unsigned long)corpus.size());
+  return 0;
+}
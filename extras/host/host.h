@@ -0,0 +1,223 @@
+/*
+  host.h - Helpers shared by the host benchmarks and tests
+  
+  The programs in this directory run the library sources on a PC against
+  the shims in shim/: a VirtualClock for time, a mock U8G2_NULL display
+  and HostInput for the buttons. Typist drives a keyboard the way a user
+  would, taking the key labels from the mock display and the selection
+  from the observer interface, and counts the presses it needed.
+*/
+
+#ifndef HOST_H
+#define HOST_H
+
+#include <OLEDKeyboard.h>
+#include <chrono>
+#include <ctype.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+// Events pressed by the host program, read by the keyboard on its next
+// update()
+class HostInput : public InputSource {
+  public:
+    HostInput() : _head(0), _count(0) {}
+    
+    void press(InputEvent event) {
+      if (_count < QUEUE_SIZE) {
+        _queue[(_head + _count++) % QUEUE_SIZE] = event;
+      }
+    }
+    
+    InputEvent read() {
+      if (_count == 0) {
+        return EVENT_NONE;
+      }
+      InputEvent event = _queue[_head];
+      _head = (_head + 1) % QUEUE_SIZE;
+      _count--;
+      return event;
+    }
+    
+    unsigned long nextDeadlineMs() const {
+      return (_count > 0) ? 0 : NO_DEADLINE;
+    }
+    
+  private:
+    static const int QUEUE_SIZE = 16;
+    InputEvent _queue[QUEUE_SIZE];
+    int _head;
+    int _count;
+};
+
+// Types text on a keyboard with UP, DOWN and SELECT like a user who
+// knows the layout: switch layers when the character is not shown, then
+// take the shorter way round to its key
+class Typist : public InputObserver {
+  public:
+    static const int KEY_COUNT = 32;
+    static const unsigned long PRESS_INTERVAL = 150; // Virtual ms between presses
+    
+    Typist(OLEDKeyboard& keyboard, HostInput& input, U8G2& display)
+      : _keyboard(keyboard), _input(input), _display(display), _selection(0), _length(0) {
+      resetCounts();
+      keyboard.setObserver(this);
+    }
+    
+    unsigned long presses;             // All button presses
+    unsigned long moves;               // UP and DOWN presses
+    unsigned long characters;          // Characters entered
+    
+    void resetCounts() {
+      presses = 0;
+      moves = 0;
+      characters = 0;
+    }
+    
+    // Types an entry and submits it; false if a character could not be
+    // reached or the keyboard holds other text. The keyboard is reset afterwards, the history cleared so
+    // it offers no suggestions.
+    bool enter(const char* text) {
+      _keyboard.reset();
+      _keyboard.update();
+      _selection = 0;
+      _length = 0;
+      
+      bool typed = type(text);
+      char entered[OLEDKEYBOARD_MAX_LENGTH + 1];
+      _keyboard.getInputText(entered, sizeof(entered));
+      typed = typed && strcmp(entered, text) == 0;
+      typed = typed && submit();
+      _keyboard.clearHistory();
+      return typed;
+    }
+    
+    // Types text at the cursor without submitting it
+    bool type(const char* text) {
+      bool typed = true;
+      for (const char* c = text; *c != '\0' && typed; c++) {
+        std::string label = (*c == ' ') ? "_" : std::string(1, *c);
+        typed = _typeKey(label);
+        characters++;
+      }
+      return typed;
+    }
+    
+    // Presses the enter key
+    bool submit() {
+      return _typeKey(">") && _keyboard.isInputComplete();
+    }
+    
+    // Presses a button, PRESS_INTERVAL after the last one
+    void press(InputEvent event, int count = 1) {
+      for (int i = 0; i < count; i++) {
+        _press(event);
+      }
+    }
+    
+    int selection() const { return _selection; }
+    
+    void onEvent(unsigned long, InputEvent, uint8_t, uint8_t selection, uint8_t length) {
+      _selection = selection;
+      _length = length;
+    }
+    
+  private:
+    OLEDKeyboard& _keyboard;
+    HostInput& _input;
+    U8G2& _display;
+    int _selection;
+    int _length;
+    
+    void _press(InputEvent event) {
+      VirtualClock::advance(PRESS_INTERVAL);
+      _input.press(event);
+      _keyboard.update();
+      presses++;
+      if (event == EVENT_UP || event == EVENT_DOWN) {
+        moves++;
+      }
+    }
+    
+    // Index of a key label in the last drawn frame, -1 if not shown. The
+    // keys are the last texts drawn, in index order.
+    int _findKey(const std::string& label) const {
+      const std::vector<HostText>& frame = _display.frame;
+      if (frame.size() < (size_t)KEY_COUNT) {
+        return -1;
+      }
+      size_t first = frame.size() - KEY_COUNT;
+      for (int i = 0; i < KEY_COUNT; i++) {
+        if (frame[first + i].text == label) {
+          return i;
+        }
+      }
+      return -1;
+    }
+    
+    bool _typeKey(const std::string& label) {
+      // At most shift plus the symbols toggle and back
+      for (int attempt = 0; attempt < 4; attempt++) {
+        int key = _findKey(label);
+        if (key >= 0) {
+          if (!_moveTo(key)) {
+            return false;
+          }
+          _press(EVENT_SELECT);
+          return true;
+        }
+        
+        // Shift leads to both letter layers, the symbols key to the rest
+        bool letter = label.size() == 1 && isalpha(label[0]);
+        int toggle = _findKey(letter ? "Aa" : "?#");
+        if (toggle < 0 || !_moveTo(toggle)) {
+          return false;
+        }
+        _press(EVENT_SELECT);
+      }
+      return false;
+    }
+    
+    // Walks to a key the shorter way round the selection ring: the keys,
+    // then the entries after the last key (the cursor and undo entries
+    // once text was typed; suggestions are avoided by clearing the
+    // history and not using a dictionary)
+    bool _moveTo(int key) {
+      int extras = (_length > 0) ? 2 : 0;
+      int ring = KEY_COUNT + extras;
+      int position = (_selection < KEY_COUNT) ? _selection : ring - 1 - (_selection - KEY_COUNT);
+      InputEvent step = ((key - position + ring) % ring <= ring / 2) ? EVENT_DOWN : EVENT_UP;
+      
+      for (int i = 0; i < 2 * ring && _selection != key; i++) {
+        _press(step);
+      }
+      return _selection == key;
+    }
+};
+
+// Lines of a text file, without empty lines and '#' comments
+inline bool loadLines(const char* path, std::vector<std::string>& lines) {
+  FILE* file = fopen(path, "r");
+  if (file == NULL) {
+    fprintf(stderr, "cannot open %s\n", path);
+    return false;
+  }
+  char line[256];
+  while (fgets(line, sizeof(line), file) != NULL) {
+    line[strcspn(line, "\r\n")] = '\0';
+    if (line[0] != '\0' && line[0] != '#') {
+      lines.push_back(line);
+    }
+  }
+  fclose(file);
+  return true;
+}
+
+// Wall-clock time for the timing benchmarks
+inline double hostSeconds() {
+  using namespace std::chrono;
+  return duration_cast<duration<double> >(steady_clock::now().time_since_epoch()).count();
+}
+
+#endif
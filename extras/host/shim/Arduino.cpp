@@ -0,0 +1,130 @@
+/*
+  Arduino.cpp - Minimal Arduino API for host builds of OLEDKeyboard
+*/
+
+#include "Arduino.h"
+#include <stdio.h>
+
+int hostPins[HOST_PINS];
+int hostAnalog[HOST_PINS];
+bool hostInterruptPins = true;
+unsigned long hostTime = 0;
+
+static void (*interruptHandlers[HOST_PINS])();
+
+unsigned long millis() {
+  return hostTime;
+}
+
+unsigned long micros() {
+  return hostTime * 1000;
+}
+
+void delay(unsigned long ms) {
+  hostTime += ms;
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  // Pull-ups make an unconnected pin read high
+  if (mode == INPUT_PULLUP) {
+    hostPins[pin] = HIGH;
+  }
+}
+
+int digitalRead(uint8_t pin) {
+  return hostPins[pin];
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+  hostPins[pin] = value;
+}
+
+int analogRead(uint8_t pin) {
+  return hostAnalog[pin];
+}
+
+int digitalPinToInterrupt(uint8_t pin) {
+  return hostInterruptPins ? pin : NOT_AN_INTERRUPT;
+}
+
+void attachInterrupt(int interrupt, void (*isr)(), int) {
+  interruptHandlers[interrupt] = isr;
+}
+
+void detachInterrupt(int interrupt) {
+  interruptHandlers[interrupt] = NULL;
+}
+
+void hostRaiseInterrupt(uint8_t pin) {
+  if (interruptHandlers[pin] != NULL) {
+    interruptHandlers[pin]();
+  }
+}
+
+// Single-threaded: nothing can interrupt the host program
+void noInterrupts() {}
+void interrupts() {}
+
+size_t Print::print(const char* text) {
+  size_t count = 0;
+  while (*text != '\0') {
+    count += write(*text++);
+  }
+  return count;
+}
+
+size_t Print::print(const __FlashStringHelper* text) {
+  return print(reinterpret_cast<const char*>(text));
+}
+
+size_t Print::print(char c) {
+  return write(c);
+}
+
+size_t Print::print(int value) {
+  return print((long)value);
+}
+
+size_t Print::print(unsigned int value) {
+  return print((unsigned long)value);
+}
+
+size_t Print::print(long value) {
+  char buffer[24];
+  snprintf(buffer, sizeof(buffer), "%ld", value);
+  return print(buffer);
+}
+
+size_t Print::print(unsigned long value) {
+  char buffer[24];
+  snprintf(buffer, sizeof(buffer), "%lu", value);
+  return print(buffer);
+}
+
+size_t Print::print(double value, int digits) {
+  char buffer[32];
+  snprintf(buffer, sizeof(buffer), "%.*f", digits, value);
+  return print(buffer);
+}
+
+size_t Print::println() {
+  return write('\n');
+}
+
+size_t Print::println(const char* text) {
+  return print(text) + println();
+}
+
+size_t Print::println(const __FlashStringHelper* text) {
+  return print(text) + println();
+}
+
+size_t Print::println(unsigned long value) {
+  return print(value) + println();
+}
+
+HostSerial Serial;
+
+size_t HostSerial::write(uint8_t c) {
+  return fputc(c, stdout) == EOF ? 0 : 1;
+}
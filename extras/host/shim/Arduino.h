@@ -0,0 +1,109 @@
+/*
+  Arduino.h - Minimal Arduino API for host builds of OLEDKeyboard
+  
+  Just enough of the core for the library sources to compile and run on
+  a PC. Pins and ADC channels are plain arrays the host programs set
+  (see host.h); millis() and micros() follow hostTime.
+*/
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+
+using std::min;
+using std::max;
+
+#define PROGMEM
+#define pgm_read_byte(address) (*(const uint8_t*)(address))
+#define pgm_read_word(address) (*(const uint16_t*)(address))
+#define pgm_read_ptr(address) (*(const void* const*)(address))
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+#define NOT_AN_INTERRUPT -1
+#define IRAM_ATTR
+
+#define bit(b) (1UL << (b))
+
+// Host state behind the Arduino calls
+const int HOST_PINS = 64;
+extern int hostPins[HOST_PINS];      // Level read by digitalRead()
+extern int hostAnalog[HOST_PINS];    // Value read by analogRead()
+extern bool hostInterruptPins;       // digitalPinToInterrupt() succeeds
+extern unsigned long hostTime;       // millis()
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void pinMode(uint8_t pin, uint8_t mode);
+int digitalRead(uint8_t pin);
+void digitalWrite(uint8_t pin, uint8_t value);
+int analogRead(uint8_t pin);
+int digitalPinToInterrupt(uint8_t pin);
+void attachInterrupt(int interrupt, void (*isr)(), int mode);
+void detachInterrupt(int interrupt);
+void hostRaiseInterrupt(uint8_t pin); // Runs the ISR attached to the pin
+void noInterrupts();
+void interrupts();
+
+class __FlashStringHelper;
+#define F(text) (reinterpret_cast<const __FlashStringHelper*>(text))
+
+class String {
+  public:
+    String() {}
+    String(const char* text) : _text(text != NULL ? text : "") {}
+    
+    unsigned int length() const { return _text.size(); }
+    const char* c_str() const { return _text.c_str(); }
+    bool reserve(unsigned int size) { _text.reserve(size); return true; }
+    String& operator+=(char c) { _text += c; return *this; }
+    String& operator+=(const char* text) { _text += text; return *this; }
+    bool operator==(const char* text) const { return _text == text; }
+    char operator[](unsigned int index) const { return _text[index]; }
+    
+  private:
+    std::string _text;
+};
+
+class Print {
+  public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    
+    size_t print(const char* text);
+    size_t print(const __FlashStringHelper* text);
+    size_t print(char c);
+    size_t print(int value);
+    size_t print(unsigned int value);
+    size_t print(long value);
+    size_t print(unsigned long value);
+    size_t print(double value, int digits = 2);
+    size_t println();
+    size_t println(const char* text);
+    size_t println(const __FlashStringHelper* text);
+    size_t println(unsigned long value);
+};
+
+// Writes to stdout
+class HostSerial : public Print {
+  public:
+    void begin(unsigned long) {}
+    size_t write(uint8_t c);
+};
+
+extern HostSerial Serial;
+
+#endif
@@ -0,0 +1,68 @@
+/*
+  U8g2lib.cpp - Mock display for host builds of OLEDKeyboard
+*/
+
+#include "U8g2lib.h"
+#include "Wire.h"
+
+static const u8g2_cb_t rotation0 = 0;
+const u8g2_cb_t* const U8G2_R0 = &rotation0;
+
+const uint8_t u8g2_font_6x10_tr[] = {0};
+
+static const int GLYPH_WIDTH = 6;
+
+int8_t u8g2_GetGlyphWidth(u8g2_t*, uint16_t) {
+  return GLYPH_WIDTH;
+}
+
+U8G2::U8G2() : _color(1), _powerSave(0) {
+  _u8g2.font = NULL;
+  resetCounters();
+}
+
+void U8G2::clearBuffer() {
+  frame.clear();
+}
+
+void U8G2::sendBuffer() {
+  full.flushes++;
+  full.bytes += WIDTH * HEIGHT / 8;
+  full.transactions += HEIGHT / 8;
+}
+
+void U8G2::updateDisplayArea(uint8_t, uint8_t, uint8_t tw, uint8_t th) {
+  partial.flushes++;
+  partial.bytes += tw * th * 8;
+  partial.transactions += th;
+}
+
+int U8G2::getUTF8Width(const char* text) {
+  // Continuation bytes add no width
+  int width = 0;
+  for (; *text != '\0'; text++) {
+    if ((*text & 0xC0) != 0x80) {
+      width += GLYPH_WIDTH;
+    }
+  }
+  return width;
+}
+
+int U8G2::drawUTF8(int x, int y, const char* text) {
+  HostText drawn;
+  drawn.x = x;
+  drawn.y = y;
+  drawn.text = text;
+  drawn.inverted = (_color == 0);
+  frame.push_back(drawn);
+  return getUTF8Width(text);
+}
+
+void U8G2::resetCounters() {
+  full = HostBus();
+  partial = HostBus();
+}
+
+// The I2C bus of Wire.h lives here too, the shims have no other state
+TwoWire Wire;
+uint8_t hostPort = 0xFF;
@@ -0,0 +1,98 @@
+/*
+  U8g2lib.h - Mock display for host builds of OLEDKeyboard
+  
+  Draws nothing, but counts what a real 128x64 SSD1306 would be sent and
+  remembers the text of the current frame, so host programs can check
+  bus traffic and read the key labels off the "screen". Every font is
+  a 6x10 monospace font.
+*/
+
+#ifndef HOST_U8G2LIB_H
+#define HOST_U8G2LIB_H
+
+#include "Arduino.h"
+#include <vector>
+
+typedef struct u8g2_struct {
+  const uint8_t* font;
+} u8g2_t;
+
+typedef int u8g2_cb_t;
+extern const u8g2_cb_t* const U8G2_R0;
+#define U8X8_PIN_NONE 255
+
+extern const uint8_t u8g2_font_6x10_tr[];
+int8_t u8g2_GetGlyphWidth(u8g2_t* u8g2, uint16_t encoding);
+
+// Traffic of one kind of flush, counted like the keyboard's BusStats:
+// 8 bytes per tile and one transaction per tile row
+struct HostBus {
+  unsigned long flushes;
+  unsigned long bytes;
+  unsigned long transactions;
+};
+
+// Text drawn since the last clearBuffer()
+struct HostText {
+  int x, y;
+  std::string text;
+  bool inverted;                     // Drawn in color 0 (selected key)
+};
+
+class U8G2 : public Print {
+  public:
+    static const int WIDTH = 128;
+    static const int HEIGHT = 64;
+    
+    U8G2();
+    
+    void begin() {}
+    u8g2_t* getU8g2() { return &_u8g2; }
+    uint16_t getDisplayWidth() { return WIDTH; }
+    uint16_t getDisplayHeight() { return HEIGHT; }
+    uint8_t getBufferTileWidth() { return WIDTH / 8; }
+    uint8_t getBufferTileHeight() { return HEIGHT / 8; }
+    
+    void clearBuffer();
+    void sendBuffer();
+    void updateDisplayArea(uint8_t tx, uint8_t ty, uint8_t tw, uint8_t th);
+    void setPowerSave(uint8_t on) { _powerSave = on; }
+    
+    void setFont(const uint8_t* font) { _u8g2.font = font; }
+    int8_t getAscent() { return 7; }
+    int8_t getDescent() { return -2; }
+    int getUTF8Width(const char* text);
+    int drawUTF8(int x, int y, const char* text);
+    int drawStr(int x, int y, const char* text) { return drawUTF8(x, y, text); }
+    
+    void setDrawColor(uint8_t color) { _color = color; }
+    void drawBox(int, int, int, int) {}
+    void drawFrame(int, int, int, int) {}
+    void drawHLine(int, int, int) {}
+    void drawVLine(int, int, int) {}
+    void setClipWindow(int, int, int, int) {}
+    void setMaxClipWindow() {}
+    
+    size_t write(uint8_t) { return 1; }
+    
+    // Inspection by host programs
+    HostBus full;                    // sendBuffer()
+    HostBus partial;                 // updateDisplayArea()
+    std::vector<HostText> frame;
+    bool isPoweredDown() const { return _powerSave != 0; }
+    void resetCounters();
+    
+  private:
+    u8g2_t _u8g2;
+    uint8_t _color;
+    uint8_t _powerSave;
+};
+
+// Stands in for U8g2's display-less device, with the geometry of an
+// SSD1306 so the keyboard lays itself out as on the real panel
+class U8G2_NULL : public U8G2 {
+  public:
+    U8G2_NULL(const u8g2_cb_t*) {}
+};
+
+#endif
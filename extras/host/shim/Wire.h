@@ -0,0 +1,26 @@
+/*
+  Wire.h - I2C stand-in for host builds of OLEDKeyboard
+  
+  Every read returns hostPort, the port byte of an imaginary expander.
+*/
+
+#ifndef HOST_WIRE_H
+#define HOST_WIRE_H
+
+#include "Arduino.h"
+
+extern uint8_t hostPort;             // Byte returned by read()
+
+class TwoWire {
+  public:
+    void begin() {}
+    void beginTransmission(uint8_t) {}
+    size_t write(uint8_t) { return 1; }
+    uint8_t endTransmission() { return 0; }
+    uint8_t requestFrom(uint8_t, uint8_t count) { return count; }
+    int read() { return hostPort; }
+};
+
+extern TwoWire Wire;
+
+#endif
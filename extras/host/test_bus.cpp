@@ -0,0 +1,124 @@
+/*
+  test_bus.cpp - Display traffic counters against the mock display
+  
+  Built with OLEDKEYBOARD_PROFILE. Drives a keyboard through full frames,
+  cursor blinks, a password reveal and a frame flushed by the
+  application, and checks after each that getBusStats() agrees with what
+  the mock display was sent, as well as the sizes expected for a 128x64
+  panel. Ends with the per-second rates over one window.
+  
+  Usage: ./test_bus
+*/
+
+#include "host.h"
+
+static int failures = 0;
+
+static void check(const char* name, bool ok) {
+  printf("%-4s %s\n", ok ? "ok" : "FAIL", name);
+  failures += ok ? 0 : 1;
+}
+
+static bool same(const BusStats& stats, const HostBus& sent) {
+  return stats.flushes == sent.flushes && stats.bytes == sent.bytes &&
+         stats.transactions == sent.transactions;
+}
+
+static void checkCounts(const char* name, OLEDKeyboard& keyboard, U8G2& display) {
+  const BusStats& full = keyboard.getBusStats(FLUSH_FULL);
+  const BusStats& partial = keyboard.getBusStats(FLUSH_PARTIAL);
+  bool ok = same(full, display.full) && same(partial, display.partial);
+  if (!ok) {
+    printf("     full %u/%u/%u, sent %lu/%lu/%lu; partial %u/%u/%u, sent %lu/%lu/%lu\n",
+           full.flushes, full.bytes, full.transactions,
+           display.full.flushes, display.full.bytes, display.full.transactions,
+           partial.flushes, partial.bytes, partial.transactions,
+           display.partial.flushes, display.partial.bytes, display.partial.transactions);
+  }
+  check(name, ok);
+}
+
+// Updates every 10 ms for `duration` ms
+static void run(OLEDKeyboard& keyboard, unsigned long duration) {
+  for (unsigned long t = 0; t < duration; t += 10) {
+    VirtualClock::advance(10);
+    keyboard.update();
+  }
+}
+
+int main() {
+  U8G2_NULL display(U8G2_R0);
+  HostInput input;
+  OLEDKeyboard keyboard(&display, &input);
+  VirtualClock::set(10000);
+  keyboard.setClock(VirtualClock::now);
+  keyboard.begin();
+  
+  // One full frame: 16 x 8 tiles of 8 bytes, one transfer per tile row
+  keyboard.update();
+  checkCounts("first frame counted as sent", keyboard, display);
+  check("first frame is 1024 bytes in 8 transfers",
+        display.full.flushes == 1 && display.full.bytes == 1024 && display.full.transactions == 8);
+  
+  input.press(EVENT_SELECT);
+  VirtualClock::advance(10);
+  keyboard.update();
+  checkCounts("frame after a key press", keyboard, display);
+  
+  // The cursor blinks in the 14 px input area: at most 2 x 2 tiles
+  run(keyboard, 600);
+  checkCounts("cursor blink", keyboard, display);
+  check("blink sent as one partial update of at most 2 x 2 tiles",
+        display.partial.flushes == 1 && display.partial.bytes <= 32 && display.partial.transactions <= 2 &&
+        display.full.flushes == 2);
+  run(keyboard, 5000);
+  checkCounts("ten more blinks", keyboard, display);
+  check("ten more blinks sent as partial updates", display.partial.flushes == 11 && display.full.flushes == 2);
+  
+  // A revealed password character is concealed by a partial update
+  keyboard.setMasked(true);
+  keyboard.setRevealTime(300);
+  keyboard.setCursorBlinkInterval(0x7FFF);
+  input.press(EVENT_SELECT);
+  VirtualClock::advance(10);
+  keyboard.update();
+  unsigned long partialBefore = display.partial.flushes;
+  run(keyboard, 400);
+  checkCounts("password reveal", keyboard, display);
+  check("reveal concealed by one partial update", display.partial.flushes == partialBefore + 1);
+  
+  // A frame the application flushes itself, e.g. through OLEDCompositor
+  display.clearBuffer();
+  keyboard.render();
+  display.sendBuffer();
+  keyboard.frameSent();
+  checkCounts("frame flushed by the application", keyboard, display);
+  
+  // Rates over one window, which resetStageStats() restarts: a second of
+  // blinking and a key press just before it ends
+  keyboard.setCursorBlinkInterval(300);
+  keyboard.setMasked(false);
+  VirtualClock::advance(10);
+  keyboard.update();
+  keyboard.resetStageStats();
+  display.resetCounters();
+  check("counters cleared", keyboard.getBusStats(FLUSH_FULL).bytes == 0 && keyboard.getBusStats(FLUSH_PARTIAL).bytes == 0);
+  
+  run(keyboard, 980);
+  input.press(EVENT_DOWN);
+  run(keyboard, 10);
+  HostBus full = display.full;
+  HostBus partial = display.partial;
+  run(keyboard, 10);                 // Closes the window before drawing
+  const BusStats& fullStats = keyboard.getBusStats(FLUSH_FULL);
+  const BusStats& partialStats = keyboard.getBusStats(FLUSH_PARTIAL);
+  printf("     window: full %lu bytes, partial %lu bytes\n", full.bytes, partial.bytes);
+  check("full bytes and transfers per second",
+        full.flushes > 0 && fullStats.bytesPerSecond == full.bytes &&
+        fullStats.transactionsPerSecond == full.transactions);
+  check("partial bytes and transfers per second",
+        partial.flushes > 0 && partialStats.bytesPerSecond == partial.bytes &&
+        partialStats.transactionsPerSecond == partial.transactions);
+  
+  return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,73 @@
+/*
+  test_deadline.cpp - Wake-up deadlines of button sources
+  
+  A host sleeping for nextDeadlineMs() only sees a press through an
+  interrupt. Checks that buttons and the encoder button ask to be polled
+  within InputSource::POLL_INTERVAL until their interrupts are attached,
+  and again after a failed attach or a detach, also on an idle keyboard.
+  
+  Usage: ./test_deadline
+*/
+
+#include "host.h"
+
+static int failures = 0;
+
+static void check(const char* name, bool ok) {
+  printf("%-4s %s\n", ok ? "ok" : "FAIL", name);
+  failures += ok ? 0 : 1;
+}
+
+static bool polled(const InputSource& source) {
+  return source.nextDeadlineMs() <= InputSource::POLL_INTERVAL;
+}
+
+// Interrupt handler; only the deadlines are checked
+static void wake() {
+}
+
+int main() {
+  VirtualClock::set(1000);
+  hostPins[2] = hostPins[3] = hostPins[4] = HIGH;
+  
+  hostInterruptPins = true;
+  ButtonInput buttons(2, 3, 4);
+  buttons.setClock(VirtualClock::now);
+  buttons.begin();
+  check("buttons polled before attachInterrupts()", polled(buttons));
+  check("buttons attached", buttons.attachInterrupts(wake));
+  check("attached buttons wait for an interrupt", buttons.nextDeadlineMs() == InputSource::NO_DEADLINE);
+  buttons.detachInterrupts();
+  check("buttons polled after detachInterrupts()", polled(buttons));
+  
+  hostInterruptPins = false;
+  check("attach fails without interrupt pins", !buttons.attachInterrupts(wake));
+  check("buttons polled after a failed attach", polled(buttons));
+  
+  hostInterruptPins = true;
+  EncoderInput encoder(2, 3, 4);
+  encoder.setClock(VirtualClock::now);
+  encoder.begin();
+  check("encoder button polled before attachInterrupts()", polled(encoder));
+  check("encoder attached", encoder.attachInterrupts(wake));
+  check("attached encoder waits for an interrupt", encoder.nextDeadlineMs() == InputSource::NO_DEADLINE);
+  encoder.detachInterrupts();
+  check("encoder button polled after detachInterrupts()", polled(encoder));
+  
+  // An idle keyboard on the built-in buttons still wakes for a press
+  U8G2_NULL display(U8G2_R0);
+  OLEDKeyboard keyboard(&display, 2, 3, 4);
+  keyboard.setClock(VirtualClock::now);
+  keyboard.setIdleTimeout(1000);
+  keyboard.begin();
+  keyboard.update();
+  VirtualClock::advance(1500);
+  keyboard.update();
+  check("keyboard idle", keyboard.isIdle());
+  check("idle keyboard polls its buttons", keyboard.nextDeadlineMs() <= InputSource::POLL_INTERVAL);
+  check("keyboard attached", keyboard.attachInterrupts());
+  check("idle keyboard with interrupts sleeps", keyboard.nextDeadlineMs() == OLEDKeyboard::NO_DEADLINE);
+  keyboard.detachInterrupts();
+  
+  return failures > 0 ? 1 : 0;
+}
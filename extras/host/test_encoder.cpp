@@ -0,0 +1,173 @@
+/*
+  test_encoder.cpp - EncoderInput against simulated encoder waveforms
+  
+  Plays A/B waveforms (clean, bouncing, with skipped edges, fast spins)
+  into an EncoderInput, once decoded in interrupts and once polled every
+  millisecond, and checks the keys it reports. Ends with the decoding
+  cost per edge.
+  
+  Usage: ./test_encoder
+*/
+
+#include "host.h"
+
+static const int PIN_A = 2;
+static const int PIN_B = 3;
+static const int PIN_BUTTON = 4;
+
+// A/B levels (A << 1 | B) through one detent, starting and ending at rest
+static const uint8_t DETENT_DOWN[] = {1, 0, 2, 3};
+static const uint8_t DETENT_UP[] = {2, 0, 1, 3};
+
+struct Edge {
+  unsigned long time;                // ms
+  uint8_t lines;
+};
+
+typedef std::vector<Edge> Waveform;
+
+// `count` detents `interval` ms apart, transitions spread over the first
+// half of the interval. Each transition can bounce (the line that changes
+// flips back and forth first) or one per detent can be skipped (two
+// transitions seen as one, as a slow poll would).
+static void spin(Waveform& wave, int count, bool down, unsigned long interval,
+                 int bounces = 0, bool skip = false) {
+  unsigned long time = wave.empty() ? 0 : wave.back().time + interval;
+  const uint8_t* sequence = down ? DETENT_DOWN : DETENT_UP;
+  for (int i = 0; i < count; i++) {
+    uint8_t lines = 3;
+    for (int t = 0; t < 4; t++) {
+      if (skip && t == 0) {
+        continue;
+      }
+      Edge edge;
+      edge.time = time + t * interval / 8;
+      for (int b = 0; b < 2 * bounces; b++) {
+        edge.lines = (b % 2 == 0) ? sequence[t] : lines;
+        wave.push_back(edge);
+      }
+      edge.lines = lines = sequence[t];
+      wave.push_back(edge);
+    }
+    time += interval;
+  }
+}
+
+// Plays the waveform, reading the encoder every millisecond like update()
+// would, and returns the keys moved (+ = down)
+static long play(const Waveform& wave, bool interrupts, uint8_t maxSteps) {
+  hostInterruptPins = interrupts;
+  VirtualClock::set(1000);
+  hostPins[PIN_A] = hostPins[PIN_B] = hostPins[PIN_BUTTON] = HIGH;
+  
+  EncoderInput encoder(PIN_A, PIN_B, PIN_BUTTON);
+  encoder.setClock(VirtualClock::now);
+  encoder.setAcceleration(maxSteps);
+  encoder.begin();
+  
+  long keys = 0;
+  unsigned long start = VirtualClock::now();
+  unsigned long end = start + (wave.empty() ? 0 : wave.back().time) + 100;
+  size_t next = 0;
+  while (VirtualClock::now() < end) {
+    // Edges of this millisecond; a polled encoder only sees the last one
+    while (next < wave.size() && start + wave[next].time <= VirtualClock::now()) {
+      uint8_t lines = wave[next++].lines;
+      int a = lines >> 1;
+      int b = lines & 1;
+      bool changedA = hostPins[PIN_A] != a;
+      bool changedB = hostPins[PIN_B] != b;
+      hostPins[PIN_A] = a;
+      hostPins[PIN_B] = b;
+      if (interrupts && changedA) {
+        hostRaiseInterrupt(PIN_A);
+      }
+      if (interrupts && changedB) {
+        hostRaiseInterrupt(PIN_B);
+      }
+    }
+    
+    InputEvent event;
+    while ((event = encoder.read()) != EVENT_NONE) {
+      keys += (event == EVENT_DOWN) ? 1 : (event == EVENT_UP) ? -1 : 0;
+    }
+    VirtualClock::advance(1);
+  }
+  return keys;
+}
+
+static int failures = 0;
+
+static void expect(const char* name, const Waveform& wave, uint8_t maxSteps, long keys,
+                   bool polled = true) {
+  for (int mode = 0; mode < (polled ? 2 : 1); mode++) {
+    long result = play(wave, mode == 0, maxSteps);
+    bool ok = result == keys;
+    printf("%-4s %-30s %-10s expected %4ld, got %4ld\n", ok ? "ok" : "FAIL", name,
+           mode == 0 ? "interrupt" : "polled", keys, result);
+    failures += ok ? 0 : 1;
+  }
+}
+
+// Interrupt decoding time per edge, over a long clean spin
+static double nanosPerEdge() {
+  Waveform wave;
+  spin(wave, 4, true, 8);
+  hostInterruptPins = true;
+  EncoderInput encoder(PIN_A, PIN_B, PIN_BUTTON);
+  encoder.setClock(VirtualClock::now);
+  encoder.begin();
+  
+  const long rounds = 250000;
+  double start = hostSeconds();
+  for (long round = 0; round < rounds; round++) {
+    for (size_t i = 0; i < wave.size(); i++) {
+      int a = wave[i].lines >> 1;
+      int b = wave[i].lines & 1;
+      int pin = (hostPins[PIN_A] != a) ? PIN_A : PIN_B;
+      hostPins[PIN_A] = a;
+      hostPins[PIN_B] = b;
+      hostRaiseInterrupt(pin);
+    }
+    while (encoder.read() != EVENT_NONE) {
+    }
+  }
+  return (hostSeconds() - start) * 1e9 / (rounds * wave.size());
+}
+
+int main() {
+  Waveform clean;
+  spin(clean, 20, true, 50);
+  spin(clean, 20, false, 50);
+  expect("clean, 20 down and 20 up", clean, 1, 0);
+  
+  Waveform down;
+  spin(down, 20, true, 50);
+  expect("clean, 20 down", down, 1, 20);
+  
+  Waveform bouncy;
+  spin(bouncy, 25, false, 50, 3);
+  expect("bouncing, 25 up", bouncy, 1, -25);
+  
+  Waveform skipped;
+  spin(skipped, 25, true, 50, 0, true);
+  expect("skipped edge per detent", skipped, 1, 25);
+  
+  // 40 ms acceleration interval: 8 ms apart moves 4 keys after the first
+  Waveform fast;
+  spin(fast, 30, true, 8);
+  expect("fast spin, accelerated", fast, 4, 1 + 29 * 4);
+  spin(fast, 5, false, 8);
+  expect("fast spin, then reversed", fast, 4, 1 + 29 * 4 - (1 + 4 * 4));
+  
+  // Faster than a millisecond poll can follow: interrupts only
+  Waveform faster;
+  spin(faster, 50, true, 1);
+  expect("50 detents in 50 ms", faster, 1, 50, false);
+  Waveform bouncyFast;
+  spin(bouncyFast, 50, false, 2, 2);
+  expect("bouncing, 50 up in 100 ms", bouncyFast, 1, -50, false);
+  
+  printf("decode: %.1f ns per edge\n", nanosPerEdge());
+  return failures > 0 ? 1 : 0;
+}
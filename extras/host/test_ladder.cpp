@@ -0,0 +1,159 @@
+/*
+  test_ladder.cpp - LadderInput against noisy, drifting ADC traces
+  
+  Synthesises ADC readings of a resistor ladder: presses of random
+  buttons with Gaussian noise, occasional spikes and a supply drift that
+  moves every level. The ladder is sampled from a "timer" every 2 ms and
+  read every 10 ms like update(). Checks that each press gives exactly
+  one event, of the right button, and that the classification never
+  flips while a button is held or released (chatter) or settles on the
+  wrong button. Ends with the cost per sample.
+  
+  Usage: ./test_ladder
+*/
+
+#include "host.h"
+#include <math.h>
+
+static const int PIN = 0;
+static const int ADC_MAX = 1023;
+static const unsigned long SAMPLE_INTERVAL = 2;
+static const unsigned long READ_INTERVAL = 10;
+static const unsigned long SETTLE_TIME = 20; // After an edge, from then on every reading must be right
+
+// Exposes the classification, which a timer-sampled ladder only updates
+// in sample()
+class ProbedLadder : public LadderInput {
+  public:
+    ProbedLadder(int pin) : LadderInput(pin) {}
+    uint8_t held() { return readButtons(); }
+};
+
+// Deterministic noise, so a failure can be reproduced
+static uint32_t seed = 12345;
+
+static double uniform() {
+  seed ^= seed << 13;
+  seed ^= seed >> 17;
+  seed ^= seed << 5;
+  return (seed + 0.5) / 4294967296.0;
+}
+
+static double gaussian() {
+  return sqrt(-2 * log(uniform())) * cos(2 * M_PI * uniform());
+}
+
+struct Trace {
+  const char* name;
+  double noise;                      // Standard deviation in counts
+  double spikes;                     // Chance of a +-120 count spike per sample
+  double drift;                      // Peak supply drift, fraction of each level
+  int buttons;                       // Ladder buttons fitted, 3 or 6
+};
+
+static int failures = 0;
+
+static void run(const Trace& trace) {
+  ProbedLadder ladder(PIN);
+  ladder.setClock(VirtualClock::now);
+  if (trace.buttons == 6) {
+    // Six levels and idle, evenly spaced
+    for (int e = EVENT_UP; e <= EVENT_BACK; e++) {
+      ladder.setLevel((InputEvent)e, (e - EVENT_UP) * ADC_MAX / 6);
+    }
+  }
+  ladder.begin();
+  VirtualClock::set(5000);
+  ladder.sample();
+  
+  const int presses = 2000;
+  long wrongEvents = 0, missedEvents = 0, extraEvents = 0;
+  long chatter = 0, misclassified = 0;
+  unsigned long samples = 0;
+  
+  for (int press = 0; press < presses; press++) {
+    // Hold shorter than the 200 ms repeat, release long enough that the
+    // same button may press again
+    InputEvent button = (InputEvent)(EVENT_UP + (int)(uniform() * trace.buttons));
+    unsigned long hold = 60 + (unsigned long)(uniform() * 100);
+    unsigned long release = 220 + (unsigned long)(uniform() * 100);
+    int events = 0;
+    
+    for (int phase = 0; phase < 2; phase++) {
+      InputEvent truth = (phase == 0) ? button : EVENT_NONE;
+      unsigned long length = (phase == 0) ? hold : release;
+      int changes = 0;
+      uint8_t last = ladder.held();
+      
+      for (unsigned long t = 0; t < length; t += SAMPLE_INTERVAL) {
+        unsigned long now = VirtualClock::now();
+        double supply = 1 + trace.drift * sin(now / 7000.0);
+        double level = (truth == EVENT_NONE) ? ADC_MAX : ladder.getLevel(truth) * supply;
+        level += trace.noise * gaussian();
+        if (uniform() < trace.spikes) {
+          level += (uniform() < 0.5) ? -120 : 120;
+        }
+        hostAnalog[PIN] = (int)min(max(level, 0.0), (double)ADC_MAX);
+        ladder.sample();
+        samples++;
+        
+        uint8_t held = ladder.held();
+        if (held != last) {
+          changes++;
+          last = held;
+        }
+        uint8_t expected = (truth == EVENT_NONE) ? 0 : bit(truth);
+        if (t >= SETTLE_TIME && held != expected) {
+          misclassified++;
+        }
+        
+        if (now % READ_INTERVAL == 0) {
+          InputEvent event;
+          while ((event = ladder.read()) != EVENT_NONE) {
+            events++;
+            wrongEvents += (event != button) ? 1 : 0;
+          }
+        }
+        VirtualClock::advance(SAMPLE_INTERVAL);
+      }
+      // One change into the press and one out of it
+      chatter += (changes > 1) ? changes - 1 : 0;
+    }
+    missedEvents += (events == 0) ? 1 : 0;
+    extraEvents += (events > 1) ? events - 1 : 0;
+  }
+  
+  bool ok = wrongEvents == 0 && missedEvents == 0 && extraEvents == 0 && chatter == 0 && misclassified == 0;
+  printf("%-4s %-34s %d presses, %lu samples: wrong %ld, missed %ld, extra %ld, chatter %ld, misclassified %ld\n",
+         ok ? "ok" : "FAIL", trace.name, presses, samples, wrongEvents, missedEvents, extraEvents,
+         chatter, misclassified);
+  failures += ok ? 0 : 1;
+}
+
+// Time for sample(), each fourth one classifying
+static double nanosPerSample() {
+  LadderInput ladder(PIN);
+  ladder.setClock(VirtualClock::now);
+  ladder.begin();
+  const long count = 10000000;
+  double start = hostSeconds();
+  for (long i = 0; i < count; i++) {
+    hostAnalog[PIN] = (i & 0x400) ? ADC_MAX / 3 + (i & 15) : ADC_MAX - (i & 15);
+    ladder.sample();
+  }
+  return (hostSeconds() - start) * 1e9 / count;
+}
+
+int main() {
+  static const Trace traces[] = {
+    {"clean", 0, 0, 0, 3},
+    {"noise 25 counts", 25, 0, 0, 3},
+    {"noise 25, spikes, 4% drift", 25, 0.01, 0.04, 3},
+    {"six buttons, noise 15, 3% drift", 15, 0.005, 0.03, 6},
+  };
+  for (size_t i = 0; i < sizeof(traces) / sizeof(traces[0]); i++) {
+    run(traces[i]);
+  }
+  printf("sample: %.1f ns\n", nanosPerSample());
+  return failures > 0 ? 1 : 0;
+}
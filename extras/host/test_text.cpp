@@ -0,0 +1,121 @@
+/*
+  test_text.cpp - Editing behaviour of a headless keyboard
+  
+  Types on a keyboard like a user would and checks the text it holds
+  and shows afterwards: the reveal of masked input, completions with the
+  cursor moved into the text, IPv4 octets merged by a deleted dot and
+  undoing a long history recall.
+  
+  The completions come from the WordCompletion example's list, the
+  default WORDS of the Makefile.
+  
+  Usage: ./test_text
+*/
+
+#include "host.h"
+#include "dictionary.h"
+
+static int failures = 0;
+
+static void check(const char* name, bool ok) {
+  printf("%-4s %s\n", ok ? "ok" : "FAIL", name);
+  failures += ok ? 0 : 1;
+}
+
+// True if the last frame shows input text other than '*' and the '_'
+// cursor. The input area is drawn first, on one baseline.
+static bool showsText(const U8G2& display) {
+  const std::vector<HostText>& frame = display.frame;
+  for (size_t i = 0; i < frame.size() && frame[i].y == frame[0].y; i++) {
+    if (frame[i].text.find_first_not_of("*_") != std::string::npos) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static std::string text(OLEDKeyboard& keyboard) {
+  char buffer[OLEDKEYBOARD_MAX_LENGTH + 1];
+  keyboard.getInputText(buffer, sizeof(buffer));
+  return buffer;
+}
+
+// Selects the best suggestion, or what sits in its place: UP from the
+// first key
+static void selectFirstExtra(Typist& typist) {
+  typist.press(EVENT_UP, typist.selection() + 1);
+  typist.press(EVENT_SELECT);
+}
+
+int main() {
+  U8G2_NULL display(U8G2_R0);
+  HostInput input;
+  OLEDKeyboard keyboard(&display, &input);
+  VirtualClock::set(10000);
+  keyboard.setClock(VirtualClock::now);
+  keyboard.setMaxLength(OLEDKEYBOARD_MAX_LENGTH);
+  keyboard.begin();
+  keyboard.update();
+  Typist typist(keyboard, input, display);
+  
+  // The last masked character is shown for the reveal time, also while
+  // the user keeps navigating
+  keyboard.setMasked(true);
+  keyboard.setRevealTime(300);
+  typist.type("ab");
+  check("masked character revealed", showsText(display));
+  typist.press(EVENT_DOWN, 4);
+  check("reveal ends while navigating", !showsText(display));
+  keyboard.clearInput();
+  keyboard.setMasked(false);
+  
+  // Completions only extend the word at the end of the text
+  keyboard.setDictionary(benchWords);
+  typist.type("gatew");
+  check("completion offered at the end", keyboard.getCompletionCount() > 0);
+  typist.press(EVENT_LEFT, 3);
+  check("no completion with the cursor inside the word", keyboard.getCompletionCount() == 0);
+  selectFirstExtra(typist);          // Enters cursor mode instead
+  typist.press(EVENT_SELECT);
+  check("nothing inserted inside the word", text(keyboard) == "gatew");
+  typist.press(EVENT_RIGHT, 3);
+  selectFirstExtra(typist);
+  check("completion accepted at the end", text(keyboard) == "gateway");
+  keyboard.clearInput();
+  keyboard.setDictionary(NULL);
+  
+  // Deleting dots between octets leaves a run no digit may extend. Ten
+  // digits overflow a 32-bit int as five can overflow the 16-bit int of AVR.
+  keyboard.setInputProfile(PROFILE_IPV4);
+  keyboard.update();                 // Shows the digits
+  typist.type("255.255.255");
+  typist.press(EVENT_LEFT, 3);
+  typist.press(EVENT_BACK);
+  typist.press(EVENT_LEFT, 3);
+  typist.press(EVENT_BACK);
+  check("dots deleted", text(keyboard) == "255255255");
+  check("merged octets invalid", !keyboard.isInputValid());
+  typist.type("1");
+  check("no digit added to merged octets", text(keyboard) == "255255255");
+  keyboard.clearInput();
+  keyboard.setInputProfile(PROFILE_TEXT);
+  keyboard.update();
+  
+  // A recalled entry longer than the undo journal is undone as a whole,
+  // and the edits before it stay in the journal
+  typist.type("calibration interval");
+  typist.submit();
+  keyboard.reset();
+  keyboard.update();
+  typist.type("c");
+  selectFirstExtra(typist);
+  check("entry recalled", text(keyboard) == "calibration interval");
+  check("recall undone", keyboard.undo() && text(keyboard) == "c");
+  check("typing before the recall undone", keyboard.undo() && text(keyboard) == "");
+  check("typing redone", keyboard.redo() && text(keyboard) == "c");
+  check("recall not redone, its text is not kept", !keyboard.redo() && text(keyboard) == "c");
+  keyboard.clearHistory();
+  keyboard.reset();
+  
+  return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,147 @@
+#!/usr/bin/env python3
+"""
+make_dictionary.py - Build a completion dictionary for OLEDKeyboard
+
+Converts a word list into a compact trie stored as a PROGMEM byte array,
+ready to pass to OLEDKeyboard::setDictionary().
+
+Usage:
+  python3 make_dictionary.py words.txt > dictionary.h
+  python3 make_dictionary.py --name myWords --top 3 words.txt > dictionary.h
+
+The word list has one word per line, optionally followed by a frequency
+("gateway 120"). Words are matched case-insensitively and stored lowercase.
+Lines starting with '#' are ignored.
+
+Format (all offsets are little-endian uint16 from the start of the array):
+  node:  [child count] [completion count]
+         [completion count x word offset]
+         [child count x (character, node offset)]
+  words: null-terminated strings following the nodes
+
+The root node is at offset 0. Each node lists the most frequent words
+below it (excluding the word ending at the node itself), so the keyboard
+only has to follow one child per typed character to show completions.
+"""
+
+import argparse
+import sys
+
+MAX_SIZE = 0xFFFF
+
+
+class Node:
+    def __init__(self):
+        self.children = {}
+        self.word = None
+        self.completions = []
+        self.offset = 0
+
+
+def load_words(path):
+    words = {}
+    with open(path, encoding="ascii") as f:
+        for line in f:
+            line = line.strip()
+            if not line or line.startswith("#"):
+                continue
+            parts = line.split()
+            word = parts[0].lower()
+            freq = int(parts[1]) if len(parts) > 1 else 1
+            if " " in word or any(ord(c) > 126 for c in word):
+                raise ValueError("unsupported word: %r" % word)
+            words[word] = words.get(word, 0) + freq
+    return words
+
+
+def build_trie(words):
+    root = Node()
+    for word in words:
+        node = root
+        for c in word:
+            node = node.children.setdefault(c, Node())
+        node.word = word
+    return root
+
+
+def rank_completions(node, words, top):
+    """Collect the best words in each subtree, best first."""
+    ranked = []
+    for c in sorted(node.children):
+        child = node.children[c]
+        ranked.extend(rank_completions(child, words, top))
+        if child.word is not None:
+            ranked.append(child.word)
+    ranked.sort(key=lambda w: (-words[w], len(w), w))
+    node.completions = ranked[:top]
+    return node.completions
+
+
+def layout(root):
+    """Assign node offsets in breadth-first order, then word offsets."""
+    nodes = []
+    queue = [root]
+    offset = 0
+    while queue:
+        node = queue.pop(0)
+        node.offset = offset
+        nodes.append(node)
+        offset += 2 + 2 * len(node.completions) + 3 * len(node.children)
+        queue.extend(node.children[c] for c in sorted(node.children))
+
+    word_offsets = {}
+    for node in nodes:
+        for word in node.completions:
+            if word not in word_offsets:
+                word_offsets[word] = offset
+                offset += len(word) + 1
+    return nodes, word_offsets, offset
+
+
+def serialize(nodes, word_offsets, size):
+    if size > MAX_SIZE:
+        raise ValueError("dictionary too large (%d bytes, max %d)" % (size, MAX_SIZE))
+
+    data = bytearray()
+    for node in nodes:
+        data.append(len(node.children))
+        data.append(len(node.completions))
+        for word in node.completions:
+            data += word_offsets[word].to_bytes(2, "little")
+        for c in sorted(node.children):
+            data.append(ord(c))
+            data += node.children[c].offset.to_bytes(2, "little")
+    for word, offset in sorted(word_offsets.items(), key=lambda item: item[1]):
+        assert len(data) == offset
+        data += word.encode("ascii") + b"\0"
+    return data
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[1])
+    parser.add_argument("words", help="word list (one word per line)")
+    parser.add_argument("--name", default="keyboardDictionary", help="array name")
+    parser.add_argument("--top", type=int, default=3, help="completions per prefix")
+    args = parser.parse_args()
+
+    words = load_words(args.words)
+    root = build_trie(words)
+    rank_completions(root, words, args.top)
+    root.completions = []   # Nothing is offered before the first character
+    nodes, word_offsets, size = layout(root)
+    data = serialize(nodes, word_offsets, size)
+
+    out = sys.stdout
+    out.write("// Generated by extras/make_dictionary.py - do not edit\n")
+    out.write("// %d words, %d nodes, %d bytes\n\n" % (len(words), len(nodes), len(data)))
+    out.write("#include <Arduino.h>\n\n")
+    out.write("const uint8_t %s[] PROGMEM = {\n" % args.name)
+    for i in range(0, len(data), 12):
+        out.write("  " + ", ".join("0x%02X" % b for b in data[i:i + 12]) + ",\n")
+    out.write("};\n")
+
+    sys.stderr.write("%d words, %d nodes, %d bytes\n" % (len(words), len(nodes), len(data)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,22 @@
+/*
+  OLEDClock.cpp - Time source for OLEDKeyboard
+  
+  Created by Sk Raihan, SKR Electronics Lab
+  https://github.com/skr-electronics-lab
+*/
+
+#include "OLEDClock.h"
+
+unsigned long VirtualClock::_now = 0;
+
+unsigned long VirtualClock::now() {
+  return _now;
+}
+
+void VirtualClock::set(unsigned long ms) {
+  _now = ms;
+}
+
+void VirtualClock::advance(unsigned long ms) {
+  _now += ms;
+}
@@ -0,0 +1,31 @@
+/*
+  OLEDClock.h - Time source for OLEDKeyboard
+  
+  Created by Sk Raihan, SKR Electronics Lab
+  https://github.com/skr-electronics-lab
+  
+  All keyboard and input source timing reads a ClockFunction, millis()
+  by default. VirtualClock lets host simulations and tests run hours of
+  interaction without waiting, including the 49-day millis() wraparound.
+*/
+
+#ifndef OLEDCLOCK_H
+#define OLEDCLOCK_H
+
+#include <Arduino.h>
+
+// Returns the time in milliseconds, wrapping like millis()
+typedef unsigned long (*ClockFunction)();
+
+// Manually advanced time, e.g. keyboard.setClock(VirtualClock::now)
+class VirtualClock {
+  public:
+    static unsigned long now();
+    static void set(unsigned long ms);
+    static void advance(unsigned long ms);
+    
+  private:
+    static unsigned long _now;
+};
+
+#endif
@@ -0,0 +1,60 @@
+/*
+  OLEDCompositor.cpp - Single-flush frame composition for OLEDKeyboard
+  
+  Created by Sk Raihan, SKR Electronics Lab
+  https://github.com/skr-electronics-lab
+*/
+
+#include "OLEDCompositor.h"
+
+OLEDCompositor::OLEDCompositor(U8G2* display) {
+  _display = display;
+  _widgetCount = 0;
+#if OLEDKEYBOARD_PROFILE
+  _keyboardCount = 0;
+#endif
+}
+
+bool OLEDCompositor::add(OLEDKeyboard* keyboard) {
+  if (!add(_renderKeyboard, keyboard)) {
+    return false;
+  }
+#if OLEDKEYBOARD_PROFILE
+  _keyboards[_keyboardCount++] = keyboard;
+#endif
+  return true;
+}
+
+bool OLEDCompositor::add(DrawCallback callback, void* context) {
+  if (callback == NULL || _widgetCount >= OLEDCOMPOSITOR_MAX_WIDGETS) {
+    return false;
+  }
+  _widgets[_widgetCount].callback = callback;
+  _widgets[_widgetCount].context = context;
+  _widgetCount++;
+  return true;
+}
+
+void OLEDCompositor::clear() {
+  _widgetCount = 0;
+#if OLEDKEYBOARD_PROFILE
+  _keyboardCount = 0;
+#endif
+}
+
+void OLEDCompositor::draw() {
+  _display->clearBuffer();
+  for (uint8_t i = 0; i < _widgetCount; i++) {
+    _widgets[i].callback(_display, _widgets[i].context);
+  }
+  _display->sendBuffer();
+#if OLEDKEYBOARD_PROFILE
+  for (uint8_t i = 0; i < _keyboardCount; i++) {
+    _keyboards[i]->frameSent();
+  }
+#endif
+}
+
+void OLEDCompositor::_renderKeyboard(U8G2*, void* keyboard) {
+  static_cast<OLEDKeyboard*>(keyboard)->render();
+}
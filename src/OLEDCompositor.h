@@ -0,0 +1,55 @@
+/*
+  OLEDCompositor.h - Single-flush frame composition for OLEDKeyboard
+  
+  Created by Sk Raihan, SKR Electronics Lab
+  https://github.com/skr-electronics-lab
+  
+  Draws several widgets (keyboards placed with setRegion() and custom
+  draw callbacks) into one frame buffer and sends it to the display
+  once, instead of one full flush per widget.
+*/
+
+#ifndef OLEDCOMPOSITOR_H
+#define OLEDCOMPOSITOR_H
+
+#include <Arduino.h>
+#include <U8g2lib.h>
+#include "OLEDKeyboard.h"
+
+// Maximum number of widgets per compositor
+#ifndef OLEDCOMPOSITOR_MAX_WIDGETS
+#define OLEDCOMPOSITOR_MAX_WIDGETS 4
+#endif
+
+class OLEDCompositor {
+  public:
+    typedef void (*DrawCallback)(U8G2* display, void* context);
+    
+    // Constructor
+    OLEDCompositor(U8G2* display);
+    
+    // Widgets are drawn in the order they were added
+    bool add(OLEDKeyboard* keyboard);
+    bool add(DrawCallback callback, void* context = NULL);
+    void clear();                    // Remove all widgets
+    
+    void draw();                     // Clear, render all widgets, flush once
+    
+  private:
+    struct Widget {
+      DrawCallback callback;
+      void* context;
+    };
+    
+    U8G2* _display;
+    Widget _widgets[OLEDCOMPOSITOR_MAX_WIDGETS];
+    uint8_t _widgetCount;
+#if OLEDKEYBOARD_PROFILE
+    OLEDKeyboard* _keyboards[OLEDCOMPOSITOR_MAX_WIDGETS]; // Told when frames are sent
+    uint8_t _keyboardCount;
+#endif
+    
+    static void _renderKeyboard(U8G2* display, void* keyboard);
+};
+
+#endif
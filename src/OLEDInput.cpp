@@ -0,0 +1,542 @@
+/*
+  OLEDInput.cpp - Input sources for OLEDKeyboard
+  
+  Created by Sk Raihan, SKR Electronics Lab
+  https://github.com/skr-electronics-lab
+*/
+
+#include "OLEDInput.h"
+
+// Highest analogRead() value
+#if defined(ESP32)
+#define ADC_MAX 4095
+#else
+#define ADC_MAX 1023
+#endif
+
+// Time left until `duration` has passed since `start` (wrap safe)
+static inline unsigned long remaining(unsigned long now, unsigned long start, unsigned long duration) {
+  unsigned long elapsed = now - start;
+  return (elapsed >= duration) ? 0 : duration - elapsed;
+}
+
+unsigned long InputSource::nextDeadlineMs() const {
+  return NO_DEADLINE;
+}
+
+bool InputSource::attachInterrupts(void (*)()) {
+  return false;
+}
+
+void InputSource::setClock(ClockFunction clock) {
+  _clock = (clock != NULL) ? clock : millis;
+}
+
+// DebouncedInput
+
+DebouncedInput::DebouncedInput() {
+  _held = 0;
+  _ready = 0;
+  _drained = false;
+  _debounceDelay = 200;
+  for (int i = 0; i <= EVENT_BACK; i++) {
+    _lastPress[i] = 0;
+  }
+}
+
+InputEvent DebouncedInput::read() {
+  // One sample per batch: after the last ready press, EVENT_NONE ends
+  // the batch without sampling again
+  if (_ready == 0) {
+    if (_drained) {
+      _drained = false;
+      return EVENT_NONE;
+    }
+    unsigned long now = _now();
+    _held = readButtons();
+    for (int e = EVENT_UP; e <= EVENT_BACK; e++) {
+      if ((_held & bit(e)) && now - _lastPress[e] > _debounceDelay) {
+        _lastPress[e] = now;
+        _ready |= bit(e);
+      }
+    }
+    if (_ready == 0) {
+      return EVENT_NONE;
+    }
+  }
+  
+  for (int e = EVENT_UP; e <= EVENT_BACK; e++) {
+    if (_ready & bit(e)) {
+      _ready &= ~bit(e);
+      _drained = (_ready == 0);
+      return (InputEvent)e;
+    }
+  }
+  return EVENT_NONE;
+}
+
+unsigned long DebouncedInput::nextDeadlineMs() const {
+  if (_ready != 0) {
+    return 0;
+  }
+  
+  // A held button presses again once its debounce delay has passed
+  // (the check uses '>', so a tick later)
+  unsigned long now = _now();
+  unsigned long next = NO_DEADLINE;
+  for (int e = EVENT_UP; e <= EVENT_BACK; e++) {
+    if (_held & bit(e)) {
+      unsigned long wait = remaining(now, _lastPress[e], _debounceDelay + 1);
+      next = (wait < next) ? wait : next;
+    }
+  }
+  return next;
+}
+
+unsigned long DebouncedInput::_polledDeadline() const {
+  // Without an interrupt a press is only seen when read() samples, so a
+  // sleeping host has to come back regularly
+  unsigned long next = DebouncedInput::nextDeadlineMs();
+  return (next < POLL_INTERVAL) ? next : POLL_INTERVAL;
+}
+
+void DebouncedInput::setDebounceDelay(unsigned long delay) {
+  _debounceDelay = delay;
+}
+
+// ButtonInput
+
+ButtonInput::ButtonInput(int upPin, int downPin, int selectPin) {
+  _pins[0] = upPin;
+  _pins[1] = downPin;
+  _pins[2] = selectPin;
+  _interrupts = false;
+}
+
+void ButtonInput::begin() {
+  for (int i = 0; i < 3; i++) {
+    pinMode(_pins[i], INPUT_PULLUP);
+  }
+}
+
+uint8_t ButtonInput::readButtons() {
+  uint8_t held = 0;
+  for (int i = 0; i < 3; i++) {
+    if (digitalRead(_pins[i]) == LOW) {
+      held |= bit(EVENT_UP + i);
+    }
+  }
+  return held;
+}
+
+unsigned long ButtonInput::nextDeadlineMs() const {
+  return _interrupts ? DebouncedInput::nextDeadlineMs() : _polledDeadline();
+}
+
+bool ButtonInput::attachInterrupts(void (*isr)()) {
+  // Pins without interrupt support are still polled as usual
+  bool attached = true;
+  for (int i = 0; i < 3; i++) {
+    int interrupt = digitalPinToInterrupt(_pins[i]);
+    if (interrupt == NOT_AN_INTERRUPT) {
+      attached = false;
+    } else {
+      attachInterrupt(interrupt, isr, FALLING);
+    }
+  }
+  _interrupts = attached;
+  return attached;
+}
+
+void ButtonInput::detachInterrupts() {
+  _interrupts = false;
+  for (int i = 0; i < 3; i++) {
+    int interrupt = digitalPinToInterrupt(_pins[i]);
+    if (interrupt != NOT_AN_INTERRUPT) {
+      detachInterrupt(interrupt);
+    }
+  }
+}
+
+// EncoderInput
+
+#ifndef IRAM_ATTR
+#define IRAM_ATTR
+#endif
+
+// Direction of each transition, indexed by (previous A/B << 2) | A/B;
+// invalid jumps (both lines changed) count as nothing. Kept in RAM, as
+// it is read in interrupts.
+static const int8_t encoderTable[16] = {
+   0, -1,  1,  0,
+   1,  0,  0, -1,
+  -1,  0,  0,  1,
+   0,  1, -1,  0
+};
+
+EncoderInput* EncoderInput::_active = NULL;
+void (*EncoderInput::_notify)() = NULL;
+
+EncoderInput::EncoderInput(int pinA, int pinB, int buttonPin)
+  : _pinA(pinA), _pinB(pinB), _buttonPin(buttonPin) {
+#if defined(portInputRegister)
+  _port = NULL;
+  _maskA = 0;
+  _maskB = 0;
+#endif
+  _interruptDriven = false;
+  _buttonInterrupt = false;
+  _state = 3;
+  _edges = 0;
+  _detents = 0;
+  _lastDirection = 0;
+  _steps = 0;
+  _lastDetent = 0;
+  _accelInterval = 40;
+  _maxSteps = 4;
+}
+
+void EncoderInput::begin() {
+  pinMode(_pinA, INPUT_PULLUP);
+  pinMode(_pinB, INPUT_PULLUP);
+  pinMode(_buttonPin, INPUT_PULLUP);
+#if defined(portInputRegister)
+  // Both lines in one register are sampled together, so the decoder
+  // never sees A from one moment and B from the next
+  if (digitalPinToPort(_pinA) == digitalPinToPort(_pinB)) {
+    _port = (const volatile EncoderPort*)portInputRegister(digitalPinToPort(_pinA));
+    _maskA = digitalPinToBitMask(_pinA);
+    _maskB = digitalPinToBitMask(_pinB);
+  }
+#endif
+  _state = _readLines();
+  
+  // Every edge of A and B is decoded in an interrupt, so fast spins
+  // lose no transitions between updates
+  int interruptA = digitalPinToInterrupt(_pinA);
+  int interruptB = digitalPinToInterrupt(_pinB);
+  _interruptDriven = (interruptA != NOT_AN_INTERRUPT && interruptB != NOT_AN_INTERRUPT);
+  if (_interruptDriven) {
+    _active = this;
+    attachInterrupt(interruptA, _onEdge, CHANGE);
+    attachInterrupt(interruptB, _onEdge, CHANGE);
+  }
+}
+
+InputEvent EncoderInput::read() {
+  if (!_interruptDriven) {
+    _decode();
+  }
+  
+  noInterrupts();
+  int8_t detents = _detents;
+  _detents = 0;
+  interrupts();
+  if (detents != 0) {
+    _addDetents(detents);
+  }
+  
+  if (_steps > 0) {
+    _steps--;
+    return EVENT_DOWN;
+  }
+  if (_steps < 0) {
+    _steps++;
+    return EVENT_UP;
+  }
+  return DebouncedInput::read();
+}
+
+unsigned long EncoderInput::nextDeadlineMs() const {
+  if (_steps != 0 || _detents != 0) {
+    return 0;
+  }
+  // Polled encoder lines need frequent reads, a polled button less so
+  if (!_interruptDriven) {
+    return 1;
+  }
+  return _buttonInterrupt ? DebouncedInput::nextDeadlineMs() : _polledDeadline();
+}
+
+bool EncoderInput::attachInterrupts(void (*isr)()) {
+  _notify = isr;
+  int interrupt = digitalPinToInterrupt(_buttonPin);
+  if (interrupt != NOT_AN_INTERRUPT) {
+    attachInterrupt(interrupt, isr, FALLING);
+  }
+  _buttonInterrupt = (interrupt != NOT_AN_INTERRUPT);
+  return _interruptDriven && _buttonInterrupt;
+}
+
+void EncoderInput::detachInterrupts() {
+  _notify = NULL;
+  _buttonInterrupt = false;
+  int interrupt = digitalPinToInterrupt(_buttonPin);
+  if (interrupt != NOT_AN_INTERRUPT) {
+    detachInterrupt(interrupt);
+  }
+}
+
+void EncoderInput::setAcceleration(uint8_t maxSteps, unsigned long interval) {
+  _maxSteps = (maxSteps > 0) ? maxSteps : 1;
+  _accelInterval = interval;
+}
+
+uint8_t EncoderInput::readButtons() {
+  return (digitalRead(_buttonPin) == LOW) ? bit(EVENT_SELECT) : 0;
+}
+
+void IRAM_ATTR EncoderInput::_onEdge() {
+  EncoderInput* encoder = _active;
+  if (encoder != NULL && encoder->_decode() && _notify != NULL) {
+    _notify();
+  }
+}
+
+uint8_t IRAM_ATTR EncoderInput::_readLines() const {
+#if defined(portInputRegister)
+  if (_port != NULL) {
+    EncoderPort levels = *_port;
+    return ((levels & _maskA) ? 2 : 0) | ((levels & _maskB) ? 1 : 0);
+  }
+#endif
+  return (digitalRead(_pinA) << 1) | digitalRead(_pinB);
+}
+
+// Runs in the interrupt: only the lines are read, the clock is left to
+// read(), so the keyboard's clock function need not be interrupt safe
+bool IRAM_ATTR EncoderInput::_decode() {
+  uint8_t state = _readLines();
+  if (state == _state) {
+    return false;
+  }
+  _edges += encoderTable[(_state << 2) | state];
+  _state = state;
+  
+  // Detents rest with both lines high; count one when at least half of
+  // the transitions to it went one way, so bounces cancel out
+  if (state != 3) {
+    return false;
+  }
+  int8_t direction = (_edges >= 2) ? 1 : (_edges <= -2) ? -1 : 0;
+  _edges = 0;
+  if (direction == 0) {
+    return false;
+  }
+  int total = _detents + direction;
+  _detents = (total > 100) ? 100 : (total < -100) ? -100 : total;
+  return true;
+}
+
+void EncoderInput::_addDetents(int8_t detents) {
+  // Detents the same way as before move further the shorter their
+  // average gap since the last read() that took any
+  unsigned long now = _now();
+  int8_t direction = (detents > 0) ? 1 : -1;
+  int count = detents * direction;
+  unsigned long gap = (now - _lastDetent) / count;
+  int steps = 1;
+  if (direction == _lastDirection && gap < _accelInterval) {
+    steps = (gap > 0) ? _accelInterval / gap : _maxSteps;
+    steps = (steps > _maxSteps) ? _maxSteps : (steps < 1) ? 1 : steps;
+  }
+  _lastDetent = now;
+  _lastDirection = direction;
+  
+  int total = _steps + detents * steps;
+  _steps = (total > 100) ? 100 : (total < -100) ? -100 : total;
+}
+
+// LadderInput
+
+LadderInput::LadderInput(int pin) : _pin(pin) {
+  _levels[EVENT_NONE] = ADC_MAX;
+  _levels[EVENT_UP] = 0;
+  _levels[EVENT_DOWN] = ADC_MAX / 3;
+  _levels[EVENT_SELECT] = ADC_MAX * 2 / 3;
+  _levels[EVENT_LEFT] = -1;
+  _levels[EVENT_RIGHT] = -1;
+  _levels[EVENT_BACK] = -1;
+  _oversampling = 4;
+  _hysteresis = ADC_MAX / 64;
+  _timerSampled = false;
+  _sampleCount = 0;
+  _sampleSum = 0;
+  _candidate = EVENT_NONE;
+  _pressed = EVENT_NONE;
+}
+
+void LadderInput::setLevel(InputEvent button, int level) {
+  if (button >= EVENT_UP && button <= EVENT_BACK) {
+    _levels[button] = level;
+  }
+}
+
+void LadderInput::setIdleLevel(int level) {
+  _levels[EVENT_NONE] = level;
+}
+
+int LadderInput::getLevel(InputEvent button) const {
+  return (button <= EVENT_BACK) ? _levels[button] : -1;
+}
+
+int LadderInput::calibrate(InputEvent button) {
+  long sum = 0;
+  for (int i = 0; i < 32; i++) {
+    sum += analogRead(_pin);
+    delay(1);
+  }
+  int level = sum / 32;
+  if (button == EVENT_NONE) {
+    setIdleLevel(level);
+  } else {
+    setLevel(button, level);
+  }
+  return level;
+}
+
+unsigned long LadderInput::nextDeadlineMs() const {
+  return _polledDeadline();
+}
+
+void LadderInput::setOversampling(uint8_t samples) {
+  _oversampling = (samples > 0) ? samples : 1;
+}
+
+void LadderInput::setHysteresis(int counts) {
+  _hysteresis = counts;
+}
+
+void LadderInput::sample() {
+  _timerSampled = true;
+  _addSample();
+}
+
+uint8_t LadderInput::readButtons() {
+  if (!_timerSampled) {
+    for (uint8_t i = 0; i < _oversampling; i++) {
+      _addSample();
+    }
+  }
+  uint8_t pressed = _pressed;
+  return (pressed == EVENT_NONE) ? 0 : bit(pressed);
+}
+
+void LadderInput::_addSample() {
+  _sampleSum += analogRead(_pin);
+  if (++_sampleCount >= _oversampling) {
+    // A window straddling a press or release averages two levels and may
+    // land on a third button, so a change needs two windows in a row
+    uint8_t button = _classify(_sampleSum / _sampleCount);
+    if (button == _candidate) {
+      _pressed = button;
+    }
+    _candidate = button;
+    _sampleSum = 0;
+    _sampleCount = 0;
+  }
+}
+
+uint8_t LadderInput::_classify(int value) const {
+  // The nearest level wins, but the current button only gives way once
+  // the reading is `_hysteresis` past the midpoint between the two
+  uint8_t nearest = EVENT_NONE;
+  int distance = abs(value - _levels[EVENT_NONE]);
+  for (int e = EVENT_UP; e <= EVENT_BACK; e++) {
+    if (_levels[e] < 0) {
+      continue;
+    }
+    int d = abs(value - _levels[e]);
+    if (d < distance) {
+      distance = d;
+      nearest = e;
+    }
+  }
+  
+  uint8_t current = _pressed;
+  if (nearest != current && (current == EVENT_NONE || _levels[current] >= 0)) {
+    if (abs(value - _levels[current]) - distance <= 2 * _hysteresis) {
+      return current;
+    }
+  }
+  return nearest;
+}
+
+// ExpanderInput
+
+ExpanderInput::ExpanderInput(uint8_t address, uint8_t upBit, uint8_t downBit, uint8_t selectBit, TwoWire* wire)
+  : _wire(wire), _address(address) {
+  _bits[0] = upBit;
+  _bits[1] = downBit;
+  _bits[2] = selectBit;
+}
+
+void ExpanderInput::begin() {
+  // Writing 1s makes the PCF8574 pins weakly pulled-up inputs
+  _wire->beginTransmission(_address);
+  _wire->write((uint8_t)0xFF);
+  _wire->endTransmission();
+}
+
+unsigned long ExpanderInput::nextDeadlineMs() const {
+  return _polledDeadline();
+}
+
+uint8_t ExpanderInput::readButtons() {
+  if (_wire->requestFrom(_address, (uint8_t)1) != 1) {
+    return 0;
+  }
+  uint8_t port = _wire->read();
+  uint8_t held = 0;
+  for (int i = 0; i < 3; i++) {
+    if (!(port & (1 << _bits[i]))) {
+      held |= bit(EVENT_UP + i);
+    }
+  }
+  return held;
+}
+
+// ScriptedInput
+
+ScriptedInput::ScriptedInput(const char* script, unsigned long interval)
+  : _script(script), _next(script), _interval(interval) {
+  _lastStep = 0;
+}
+
+void ScriptedInput::begin() {
+  _next = _script;
+  _lastStep = _now();
+}
+
+InputEvent ScriptedInput::read() {
+  while (*_next != '\0') {
+    if (_interval > 0) {
+      unsigned long now = _now();
+      if (now - _lastStep < _interval) {
+        return EVENT_NONE;
+      }
+      _lastStep = now;
+    }
+    
+    char c = *_next++;
+    if (c == 'u') {
+      return EVENT_UP;
+    } else if (c == 'd') {
+      return EVENT_DOWN;
+    } else if (c == 's') {
+      return EVENT_SELECT;
+    }
+  }
+  return EVENT_NONE;
+}
+
+unsigned long ScriptedInput::nextDeadlineMs() const {
+  if (isFinished()) {
+    return NO_DEADLINE;
+  }
+  return remaining(_now(), _lastStep, _interval);
+}
+
+bool ScriptedInput::isFinished() const {
+  return *_next == '\0';
+}
@@ -0,0 +1,225 @@
+/*
+  OLEDInput.h - Input sources for OLEDKeyboard
+  
+  Created by Sk Raihan, SKR Electronics Lab
+  https://github.com/skr-electronics-lab
+  
+  The keyboard reads navigation and select events from an InputSource.
+  Three buttons on GPIO pins are used by default; the other sources let
+  the keyboard run from a rotary encoder, a single analog pin with a
+  resistor ladder, an I2C port expander or a scripted event sequence.
+*/
+
+#ifndef OLEDINPUT_H
+#define OLEDINPUT_H
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "OLEDClock.h"
+
+// Events produced by an input source
+enum InputEvent {
+  EVENT_NONE,
+  EVENT_UP,                          // Previous key
+  EVENT_DOWN,                        // Next key
+  EVENT_SELECT,
+  EVENT_LEFT,                        // Text cursor left
+  EVENT_RIGHT,                       // Text cursor right
+  EVENT_BACK                         // Delete before the cursor
+};
+
+class InputSource {
+  public:
+    static const unsigned long NO_DEADLINE = 0xFFFFFFFFUL;
+    static const unsigned long POLL_INTERVAL = 20; // Deadline of sources that cannot interrupt
+    
+    InputSource() : _clock(millis) {}
+    virtual ~InputSource() {}
+    
+    virtual void begin() {}          // Called by OLEDKeyboard::begin()
+    virtual InputEvent read() = 0;   // Next event, EVENT_NONE once drained
+    virtual unsigned long nextDeadlineMs() const; // Time until read() may return an event without an interrupt
+    
+    // Call `isr` from interrupt context when input arrives; false if the
+    // source has to be polled
+    virtual bool attachInterrupts(void (*isr)());
+    virtual void detachInterrupts() {}
+    
+    void setClock(ClockFunction clock); // Set by OLEDKeyboard::setClock()
+    
+  protected:
+    unsigned long _now() const { return _clock(); }
+    
+  private:
+    ClockFunction _clock;
+};
+
+// Base for sources that report which buttons are held: presses are
+// debounced and a held button repeats every debounce delay
+class DebouncedInput : public InputSource {
+  public:
+    DebouncedInput();
+    
+    InputEvent read();
+    unsigned long nextDeadlineMs() const;
+    void setDebounceDelay(unsigned long delay);
+    
+  protected:
+    virtual uint8_t readButtons() = 0; // bit(event) of each held button
+    unsigned long _polledDeadline() const; // nextDeadlineMs(), at most POLL_INTERVAL
+    
+  private:
+    uint8_t _held;                   // Buttons held at the last sample
+    uint8_t _ready;                  // Presses not returned yet
+    bool _drained;                   // Last ready press returned
+    unsigned long _lastPress[EVENT_BACK + 1];
+    unsigned long _debounceDelay;
+};
+
+// Three buttons to ground on GPIO pins (internal pull-ups)
+class ButtonInput : public DebouncedInput {
+  public:
+    ButtonInput(int upPin, int downPin, int selectPin);
+    
+    void begin();
+    unsigned long nextDeadlineMs() const; // Polled unless interrupts are attached
+    bool attachInterrupts(void (*isr)());
+    void detachInterrupts();
+    
+  protected:
+    uint8_t readButtons();
+    
+  private:
+    int8_t _pins[3];                 // Up, down, select
+    bool _interrupts;                // Every pin wakes the host
+};
+
+// Quadrature rotary encoder with push button (one full cycle per detent,
+// e.g. KY-040). A and B are decoded in interrupts when both pins support
+// them, else on each read(). Fast spins move several keys per detent.
+// Width of a GPIO input register, where the core lets A and B be read
+// in one access
+#if defined(portInputRegister)
+#if defined(__AVR__)
+typedef uint8_t EncoderPort;
+#else
+typedef uint32_t EncoderPort;
+#endif
+#endif
+
+class EncoderInput : public DebouncedInput {
+  public:
+    EncoderInput(int pinA, int pinB, int buttonPin);
+    
+    void begin();
+    InputEvent read();
+    unsigned long nextDeadlineMs() const;
+    bool attachInterrupts(void (*isr)());
+    void detachInterrupts();
+    
+    // Detents closer than `interval` ms move up to `maxSteps` keys, more
+    // the faster the spin; 1 = one key per detent
+    void setAcceleration(uint8_t maxSteps, unsigned long interval = 40);
+    
+  protected:
+    uint8_t readButtons();
+    
+  private:
+    int _pinA, _pinB, _buttonPin;
+#if defined(portInputRegister)
+    const volatile EncoderPort* _port; // Register holding A and B, NULL = two digitalRead()s
+    EncoderPort _maskA, _maskB;
+#endif
+    bool _interruptDriven;
+    bool _buttonInterrupt;           // Attached by attachInterrupts()
+    uint8_t _state;                  // Last A/B levels
+    int8_t _edges;                   // Transitions towards the next detent
+    volatile int8_t _detents;        // Decoded, not read yet, + = down
+    int8_t _lastDirection;
+    int8_t _steps;                   // Keys not returned yet, + = down
+    unsigned long _lastDetent;       // Time of the last read() that took detents
+    unsigned long _accelInterval;
+    uint8_t _maxSteps;
+    
+    static EncoderInput* _active;    // Encoder decoded in interrupts
+    static void (*_notify)();        // From attachInterrupts()
+    static void _onEdge();
+    bool _decode();                  // True when a detent completed (interrupt safe)
+    uint8_t _readLines() const;      // A << 1 | B
+    void _addDetents(int8_t detents); // Scaled by the spin speed
+};
+
+// Up to six buttons on one analog pin through a resistor ladder; each
+// button pulls the pin to its own level. Readings are averaged over
+// several samples and the nearest level wins, with hysteresis against
+// flickering between neighbours.
+class LadderInput : public DebouncedInput {
+  public:
+    LadderInput(int pin);
+    
+    unsigned long nextDeadlineMs() const; // Polled, at most POLL_INTERVAL
+    void setLevel(InputEvent button, int level); // Reading while pressed, -1 = not fitted
+    void setIdleLevel(int level);    // Reading with no button pressed
+    int getLevel(InputEvent button) const; // EVENT_NONE = idle level
+    int calibrate(InputEvent button); // Measure the level while held (blocking)
+    void setOversampling(uint8_t samples);
+    void setHysteresis(int counts);
+    
+    // Take one ADC sample; call from a timer (e.g. Ticker every 2 ms) so
+    // update() never waits for the ADC. Until then read() samples itself.
+    void sample();
+    
+  protected:
+    uint8_t readButtons();
+    
+  private:
+    int _pin;
+    int _levels[EVENT_BACK + 1];     // [EVENT_NONE] = idle level
+    uint8_t _oversampling;
+    int _hysteresis;
+    bool _timerSampled;
+    uint8_t _sampleCount;
+    long _sampleSum;
+    uint8_t _candidate;              // Button of the last window, taken once repeated
+    volatile uint8_t _pressed;       // Classified button, EVENT_NONE if none
+    
+    void _addSample();
+    uint8_t _classify(int value) const;
+};
+
+// Buttons to ground on a PCF8574 I2C port expander
+class ExpanderInput : public DebouncedInput {
+  public:
+    ExpanderInput(uint8_t address, uint8_t upBit, uint8_t downBit, uint8_t selectBit, TwoWire* wire = &Wire);
+    
+    void begin();                    // Call Wire.begin() first
+    unsigned long nextDeadlineMs() const; // Polled, at most POLL_INTERVAL
+    
+  protected:
+    uint8_t readButtons();
+    
+  private:
+    TwoWire* _wire;
+    uint8_t _address;
+    uint8_t _bits[3];                // Up, down, select
+};
+
+// Events from a string, for demos and host tests: 'u' up, 'd' down,
+// 's' select, anything else a pause
+class ScriptedInput : public InputSource {
+  public:
+    ScriptedInput(const char* script, unsigned long interval = 0);
+    
+    void begin();                    // Restart the script
+    InputEvent read();
+    unsigned long nextDeadlineMs() const;
+    bool isFinished() const;
+    
+  private:
+    const char* _script;
+    const char* _next;
+    unsigned long _interval;         // Between characters, 0 = all at once
+    unsigned long _lastStep;
+};
+
+#endif
@@ -6,6 +6,82 @@
 */
 
 #include "OLEDKeyboard.h"
+#include <ctype.h>
+
+// Completion dictionary access (format described in extras/make_dictionary.py)
+static inline uint8_t dictByte(const uint8_t* dict, uint16_t offset) {
+  return pgm_read_byte(dict + offset);
+}
+
+static inline uint16_t dictOffset(const uint8_t* dict, uint16_t offset) {
+  return dictByte(dict, offset) | (dictByte(dict, offset + 1) << 8);
+}
+
+// UTF-8 helpers (a stray continuation byte counts as a character of its own)
+static inline bool isContinuation(char c) {
+  return (c & 0xC0) == 0x80;
+}
+
+static inline int utf8Size(char lead) {
+  uint8_t b = lead;
+  return (b < 0xC0) ? 1 : (b < 0xE0) ? 2 : (b < 0xF0) ? 3 : 4;
+}
+
+// Time left until `duration` has passed since `start` (wrap safe)
+static inline unsigned long remaining(unsigned long now, unsigned long start, unsigned long duration) {
+  unsigned long elapsed = now - start;
+  return (elapsed >= duration) ? 0 : duration - elapsed;
+}
+
+#ifndef IRAM_ATTR
+#define IRAM_ATTR
+#endif
+
+#if OLEDKEYBOARD_PROFILE
+#if !defined(ARDUINO)
+#include <chrono>
+#endif
+
+// Stage timer: the cycle counter on ESP, micros() on other boards and
+// std::chrono in host builds
+static inline uint32_t profileTicks() {
+#if defined(ESP32) || defined(ESP8266)
+  return ESP.getCycleCount();
+#elif defined(ARDUINO)
+  return micros();
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+static inline uint32_t profileMicros(uint32_t ticks) {
+#if defined(ESP32) || defined(ESP8266)
+  return ticks / ESP.getCpuFreqMHz();
+#elif defined(ARDUINO)
+  return ticks;
+#else
+  return ticks / 1000;
+#endif
+}
+
+// Adds the time until the end of the scope to a stage
+class StageTimer {
+  public:
+    StageTimer(StageStats& stats) : _stats(stats), _start(profileTicks()) {}
+    ~StageTimer() { _stats.add(profileMicros(profileTicks() - _start)); }
+    
+  private:
+    StageStats& _stats;
+    uint32_t _start;
+};
+
+#define TIME_STAGE(stage) StageTimer stageTimer(_stageStats[stage])
+#else
+#define TIME_STAGE(stage)
+#endif
+
+OLEDKeyboard* OLEDKeyboard::_interruptTarget = NULL;
 
 // Keyboard layouts
 const char* const OLEDKeyboard::_keysUpper[KEY_COUNT] = {
@@ -22,134 +98,651 @@ const char* const OLEDKeyboard::_keysLower[KEY_COUNT] = {
   "Aa","?#","<","_",".","y","z",">"
 };
 
+#if OLEDKEYBOARD_SYMBOLS
 const char* const OLEDKeyboard::_keysSymbols[KEY_COUNT] = {
   "1","2","3","4","5","6","7","8",
   "9","0","@","#","$","%","&","*",
   "-","+","=","/","\\","(",")","!",
   "Aa","?#","<","_",".","?",",",">"
 };
+#endif
+
+// Keys of the usage slots after the letters (see _keySlot); without the
+// symbols layer only the non-letter keys of the lowercase layer count
+#if OLEDKEYBOARD_SYMBOLS
+#define SLOT_KEYS _keysSymbols
+#else
+#define SLOT_KEYS _keysLower
+#endif
+
+// Most frequent English successor of each letter, for PREDICT_STATIC
+const char OLEDKeyboard::_nextLetter[26] PROGMEM = {
+  'n','e','o','e','r','o','e','e','n','u','e','e','e',
+  't','n','e','u','e','t','h','r','e','a','p','o','e'
+};
+
+// Initial order of letters on the usage-ordered layer, before any usage
+const char OLEDKeyboard::_letterPriority[26] PROGMEM = {
+  'e','t','a','o','i','n','s','r','h','l','d','c','u',
+  'm','f','p','g','w','y','b','v','k','x','j','q','z'
+};
 
 OLEDKeyboard::OLEDKeyboard(U8G2* display, int upPin, int downPin, int selectPin)
-  : _display(display), _upPin(upPin), _downPin(downPin), _selectPin(selectPin) {
+  : _display(display), _buttons(upPin, downPin, selectPin), _input(&_buttons), _observer(NULL) {
   
   // Default settings
   _screenWidth = 128;
   _screenHeight = 64;
+  _regionX = 0;
+  _regionY = 0;
+  _regionWidth = 0;
+  _regionHeight = 0;
   _inputAreaHeight = 14;
   _keyWidth = 13;
   _keyHeight = 11;
   _hSpacing = 2;
   _vSpacing = 2;
   _maxInputLength = 20;
-  _debounceDelay = 200;
   _cursorBlinkInterval = 500;
   
   // Initial state
   _currentState = STATE_UPPERCASE;
-  _inputText = "";
+  _inputProfile = PROFILE_TEXT;
+  _allowedLayers = 0x07;
+  _gapStart = 0;
+  _gapEnd = OLEDKEYBOARD_MAX_LENGTH;
+  _charCount = 0;
+  _textWidth = 0;
+  _cursorOffset = 0;
+  _scrollStart = 0;
+  _scrollOffset = 0;
+  _editMode = EDIT_NONE;
+  _journalHead = 0;
+  _undoCount = 0;
+  _redoCount = 0;
+  _journalChain = false;
+  _journalBulk = false;
   _inputComplete = false;
   _cursorVisible = true;
+  _needsRedraw = true;
+  _idle = false;
+  _inputPending = false;
+  _masked = false;
+  _revealing = false;
+  _revealX = -1;
+  _revealWidth = 0;
+  _textX = 0;
+  _cursorX = -1;
   _selectedKeyIndex = 0;
-  
+  _dictionary = NULL;
+  _dictNode = NO_NODE;
+  _dictDepth = 0;
+  _keyPrediction = PREDICT_OFF;
+  memset(_learnedNext, 0, sizeof(_learnedNext));
+  _inputFont = NULL;
+  _keyFont = NULL;
+  memset(_advance, 0, sizeof(_advance));
+  _inputAscent = 0;
+  _keyAscent = 0;
+  _labelKeys = NULL;
+  _frequentLayer = false;
+  memset(_keyUsage, 0, sizeof(_keyUsage));
+  _buildFrequentLayer();
+  memset(_history, 0xFF, sizeof(_history));
+  _layouts[STATE_UPPERCASE] = _keysUpper;
+  _layouts[STATE_LOWERCASE] = _keysLower;
+#if OLEDKEYBOARD_SYMBOLS
+  _layouts[STATE_SYMBOLS] = _keysSymbols;
+#else
+  _layouts[STATE_SYMBOLS] = NULL;    // Until set with setLayout()
+#endif
+
   // Timing
+  _clock = millis;
   _lastCursorBlink = 0;
-  _lastUpPress = 0;
-  _lastDownPress = 0;
-  _lastSelectPress = 0;
+  _revealStart = 0;
+  _revealTime = 1000;
+  _lastActivity = 0;
+  _idleTimeout = 0;
+
+#if OLEDKEYBOARD_PROFILE
+  resetStageStats();                 // After _clock, restarts the bus window
+  _edgeTicks = 0;
+  _edgeStamped = false;
+  _latencyStart = 0;
+  _latencyPending = false;
+  _statsOutput = NULL;
+  _statsInterval = 0;
+  _lastStatsDump = 0;
+#endif
+}
+
+OLEDKeyboard::OLEDKeyboard(U8G2* display, InputSource* input)
+  : OLEDKeyboard(display, -1, -1, -1) {
+  setInput(input);
 }
 
 void OLEDKeyboard::begin() {
-  // Initialize pins
-  pinMode(_upPin, INPUT_PULLUP);
-  pinMode(_downPin, INPUT_PULLUP);
-  pinMode(_selectPin, INPUT_PULLUP);
+  // Initialize input
+  _input->begin();
   
   // Get actual display dimensions
   _screenWidth = _display->getDisplayWidth();
   _screenHeight = _display->getDisplayHeight();
+  if (_regionWidth == 0) {
+    _regionWidth = _screenWidth;
+    _regionHeight = _screenHeight;
+  }
   
   // Calculate layout
   _calculateLayout();
   
-  // Set default font
-  _display->setFont(u8g2_font_6x10_tr);
+  // Default fonts unless set before begin(); the input font is left
+  // selected on the display as before
+  if (_inputFont == NULL) {
+    setInputFont(u8g2_font_6x10_tr);
+  }
+  if (_keyFont == NULL) {
+    setKeyFont(u8g2_font_6x10_tr);
+  }
+  _display->setFont(_inputFont);
+  _lastActivity = _clock();
+#if OLEDKEYBOARD_PROFILE
+  _busWindowStart = _clock();
+#endif
 }
 
 bool OLEDKeyboard::update() {
+  bool revealing = _revealing;
+#if OLEDKEYBOARD_CURSOR_BLINK
+  bool cursorVisible = _cursorVisible;
+#endif
+  poll();
+  
+  // Only redraw what changed: a concealed character and the blinking
+  // cursor are patched in place
+  if (_needsRedraw) {
+    draw();
+  } else {
+    if (revealing && !_revealing) {
+      _concealRevealed();
+    }
+#if OLEDKEYBOARD_CURSOR_BLINK
+    if (cursorVisible != _cursorVisible) {
+      _blinkCursor();
+    }
+#endif
+  }
+
+#if OLEDKEYBOARD_PROFILE
+  if (_statsInterval > 0 && _clock() - _lastStatsDump >= _statsInterval) {
+    _lastStatsDump = _clock();
+    printStageStats(*_statsOutput);
+  }
+#endif
+
+  return _inputComplete;
+}
+
+bool OLEDKeyboard::poll() {
+  bool pending = _inputPending;
+  _inputPending = false;
+
+#if OLEDKEYBOARD_PROFILE
+  // Bus rates over windows of at least a second
+  unsigned long elapsed = _clock() - _busWindowStart;
+  if (elapsed >= 1000) {
+    for (int i = 0; i < FLUSH_KIND_COUNT; i++) {
+      _busStats[i].closeWindow(elapsed);
+    }
+    _busWindowStart += elapsed;
+  }
+#endif
+
+  // While idle only watch for input; the events that wake the keyboard
+  // are dropped
+  if (_idle) {
+    if (_input->read() != EVENT_NONE || pending) {
+      while (_input->read() != EVENT_NONE) {
+      }
+      _wake();
+    }
+    return _inputComplete;
+  }
+  
   handleInput();
   
-  // Handle cursor blinking
-  if (millis() - _lastCursorBlink > _cursorBlinkInterval) {
+  // Handle cursor blinking (update() redraws just the cursor)
+  unsigned long now = _clock();
+#if OLEDKEYBOARD_CURSOR_BLINK
+  if ((uint16_t)(now - _lastCursorBlink) > _cursorBlinkInterval) {
     _cursorVisible = !_cursorVisible;
-    _lastCursorBlink = millis();
+    _lastCursorBlink = now;
+  }
+#endif
+
+  if (_revealing && (uint16_t)(now - _revealStart) >= _revealTime) {
+    _revealing = false;
   }
   
-  draw();
+  if (_idleTimeout > 0 && now - _lastActivity >= _idleTimeout) {
+    _idle = true;
+    _revealing = false;
+    _display->setPowerSave(1);
+  }
   
   return _inputComplete;
 }
 
-void OLEDKeyboard::handleInput() {
-  unsigned long currentTime = millis();
-  
-  // Handle UP button
-  if (digitalRead(_upPin) == LOW && (currentTime - _lastUpPress > _debounceDelay)) {
-    _lastUpPress = currentTime;
-    _selectedKeyIndex = (_selectedKeyIndex - 1 + KEY_COUNT) % KEY_COUNT;
+unsigned long OLEDKeyboard::nextDeadlineMs() const {
+  if (_inputPending || _needsRedraw) {
+    return 0;
+  }
+  if (_idle) {
+    return _input->nextDeadlineMs(); // Polled sources must still be read to wake
   }
   
-  // Handle DOWN button
-  if (digitalRead(_downPin) == LOW && (currentTime - _lastDownPress > _debounceDelay)) {
-    _lastDownPress = currentTime;
-    _selectedKeyIndex = (_selectedKeyIndex + 1) % KEY_COUNT;
+  // Blinking uses '>', so it fires a tick later. A cursor that is not
+  // drawn blinking needs no wake-ups.
+  unsigned long now = _clock();
+#if OLEDKEYBOARD_CURSOR_BLINK
+  uint16_t blinked = now - _lastCursorBlink; // 16-bit stamp, so 16-bit elapsed
+  unsigned long next = (_cursorX < 0) ? NO_DEADLINE : remaining(blinked, 0, _cursorBlinkInterval + 1UL);
+#else
+  unsigned long next = NO_DEADLINE;
+#endif
+  unsigned long wait = _input->nextDeadlineMs();
+  next = (wait < next) ? wait : next;
+  
+  if (_revealing) {
+    uint16_t revealed = now - _revealStart;
+    wait = remaining(revealed, 0, _revealTime);
+    next = (wait < next) ? wait : next;
+  }
+  if (_idleTimeout > 0) {
+    wait = remaining(now, _lastActivity, _idleTimeout);
+    next = (wait < next) ? wait : next;
+  }
+  return next;
+}
+
+bool OLEDKeyboard::attachInterrupts() {
+  detachInterrupts();
+  _interruptTarget = this;
+  return _input->attachInterrupts(_onButtonInterrupt);
+}
+
+void OLEDKeyboard::detachInterrupts() {
+  if (_interruptTarget != this) {
+    return;
+  }
+  _input->detachInterrupts();
+  _interruptTarget = NULL;
+}
+
+void IRAM_ATTR OLEDKeyboard::_onButtonInterrupt() {
+  if (_interruptTarget != NULL) {
+    _interruptTarget->_inputPending = true;
+#if OLEDKEYBOARD_PROFILE
+    if (!_interruptTarget->_edgeStamped) {
+      _interruptTarget->_edgeTicks = profileTicks();
+      _interruptTarget->_edgeStamped = true;
+    }
+#endif
+  }
+}
+
+void OLEDKeyboard::_wake() {
+  unsigned long now = _clock();
+  if (_idle) {
+    _display->setPowerSave(0);
+    _idle = false;
   }
+  _lastActivity = now;
+  _cursorVisible = true;
+  _lastCursorBlink = now;
+  _needsRedraw = true;
+}
+
+void OLEDKeyboard::handleInput() {
+  TIME_STAGE(STAGE_INPUT);
+  InputEvent event;
+  while ((event = _input->read()) != EVENT_NONE) {
+#if OLEDKEYBOARD_PROFILE
+    // Latency runs from the interrupt edge if there was one, else from
+    // the poll that found the event
+    if (!_latencyPending) {
+      _latencyStart = _edgeStamped ? _edgeTicks : profileTicks();
+      _latencyPending = true;
+    }
+#endif
+    _handleEvent(event);
+    if (_observer != NULL) {
+      _observer->onEvent(_lastActivity, event, _currentState, _selectedKeyIndex, _charCount);
+    }
+  }
+#if OLEDKEYBOARD_PROFILE
+  _edgeStamped = false;
+#endif
+}
+
+void OLEDKeyboard::_handleEvent(InputEvent event) {
+  _lastActivity = _clock();
+  _needsRedraw = true;
   
-  // Handle SELECT button
-  if (digitalRead(_selectPin) == LOW && (currentTime - _lastSelectPress > _debounceDelay)) {
-    _lastSelectPress = currentTime;
-    
-    const char* const* currentKeys = _getCurrentKeys();
-    const char* selectedKey = currentKeys[_selectedKeyIndex];
-    
-    _processKeyPress(selectedKey);
+  if (event == EVENT_UP) {
+    // Cursor left / undo in edit modes
+    if (_editMode == EDIT_CURSOR) {
+      _moveCursor(-1);
+    } else if (_editMode == EDIT_UNDO) {
+      undo();
+    } else {
+      _moveSelection(-1);
+    }
+  } else if (event == EVENT_DOWN) {
+    // Cursor right / redo in edit modes
+    if (_editMode == EDIT_CURSOR) {
+      _moveCursor(1);
+    } else if (_editMode == EDIT_UNDO) {
+      redo();
+    } else {
+      _moveSelection(1);
+    }
+  } else if (event == EVENT_SELECT) {
+    if (_editMode != EDIT_NONE) {
+      // Leave the edit mode and continue typing at the cursor
+      _editMode = EDIT_NONE;
+      _selectedKeyIndex = 0;
+    } else if (_selectedKeyIndex >= KEY_COUNT) {
+      _selectExtra(_selectedKeyIndex - KEY_COUNT);
+    } else {
+      const char* const* currentKeys = _getCurrentKeys();
+      const char* selectedKey = currentKeys[_selectedKeyIndex];
+      
+      _processKeyPress(selectedKey);
+    }
+    _moveSelection(0);
+  } else if (event == EVENT_LEFT) {
+    _moveCursor(-1);
+  } else if (event == EVENT_RIGHT) {
+    _moveCursor(1);
+  } else if (event == EVENT_BACK) {
+    _handleSpecialKey("<");
+    _moveSelection(0);
   }
 }
 
 void OLEDKeyboard::draw() {
   _display->clearBuffer();
+  render();
+  {
+    TIME_STAGE(STAGE_FLUSH);
+    _display->sendBuffer();
+  }
+#if OLEDKEYBOARD_PROFILE
+  frameSent();
+#endif
+}
+
+void OLEDKeyboard::render() {
+  _needsRedraw = false;
+  const uint8_t* previous = _useFont(_inputFont);
+  _clipToRegion();
   _drawInputArea();
+  _useFont(_keyFont);
   _drawKeyboard();
-  _display->sendBuffer();
+  _display->setMaxClipWindow();
+  _useFont(previous);
+}
+
+void OLEDKeyboard::_clipToRegion() {
+  _display->setClipWindow(_regionX, _regionY, _regionX + _regionWidth, _regionY + _regionHeight);
+}
+
+void OLEDKeyboard::_concealRevealed() {
+  if (_revealX < 0) {
+    return;
+  }
+  
+  // Redraw the '*' into the buffer and send only the tiles it covers
+  const uint8_t* previous = _useFont(_inputFont);
+  int top = _regionY + 2;
+  int height = _inputAreaHeight - 4;
+  _display->setDrawColor(0);
+  _display->drawBox(_revealX, top, _revealWidth, height);
+  _display->setDrawColor(1);
+  _display->drawStr(_revealX, _regionY + (_inputAreaHeight + _inputAscent + 1) / 2, "*");
+  _useFont(previous);
+  
+  int tileX = _revealX / 8;
+  int tileY = top / 8;
+  _sendTiles(tileX, tileY, (_revealX + _revealWidth - 1) / 8 - tileX + 1, (top + height - 1) / 8 - tileY + 1);
+  _revealX = -1;
+}
+
+#if OLEDKEYBOARD_CURSOR_BLINK
+void OLEDKeyboard::_blinkCursor() {
+  if (_cursorX < 0) {
+    return;
+  }
+  if (_revealX >= 0) {
+    // A revealed glyph may reach into the cursor cell
+    draw();
+    return;
+  }
+  
+  // Redraw the text under the cursor cell and send only its tiles
+  const uint8_t* previous = _useFont(_inputFont);
+  int top = _regionY + 1;
+  int bottom = _regionY + _inputAreaHeight - 1;
+  int right = _cursorX + ((_gapStart < _textLength()) ? 1 : _stringWidth("_"));
+  if (right > _regionX + _regionWidth - 1) {
+    right = _regionX + _regionWidth - 1;
+  }
+  int baseline = _regionY + (_inputAreaHeight + _inputAscent + 1) / 2;
+  _display->setClipWindow(_cursorX, top, right, bottom);
+  _display->setDrawColor(0);
+  _display->drawBox(_cursorX, top, right - _cursorX, bottom - top);
+  _display->setDrawColor(1);
+  _drawVisibleText(_textX, baseline);
+  if (_cursorVisible) {
+    _drawCursor(_cursorX, baseline);
+  }
+  _display->setMaxClipWindow();
+  _useFont(previous);
+  
+  int tileX = _cursorX / 8;
+  int tileY = top / 8;
+  _sendTiles(tileX, tileY, (right - 1) / 8 - tileX + 1, (bottom - 1) / 8 - tileY + 1);
+}
+#endif
+
+void OLEDKeyboard::_sendTiles(int tileX, int tileY, int tileWidth, int tileHeight) {
+  {
+    TIME_STAGE(STAGE_FLUSH);
+    _display->updateDisplayArea(tileX, tileY, tileWidth, tileHeight);
+  }
+#if OLEDKEYBOARD_PROFILE
+  _busStats[FLUSH_PARTIAL].add(tileWidth, tileHeight);
+#endif
+}
+
+void OLEDKeyboard::_drawVisibleText(int x, int baseline) {
+  // Copy the visible text out of the gap buffer; characters beyond the
+  // right edge are clipped
+  char visible[OLEDKEYBOARD_MAX_LENGTH + 1];
+  int count = 0;
+  int length = _textLength();
+  for (int i = _scrollStart; i < length; i++) {
+    char c = _charAt(i);
+    if (!_masked) {
+      visible[count++] = c;
+    } else if (!isContinuation(c)) {
+      visible[count++] = '*';
+    }
+  }
+  visible[count] = '\0';
+  _display->drawUTF8(x, baseline, visible);
+}
+
+void OLEDKeyboard::_drawCursor(int x, int baseline) {
+  if (_gapStart < _textLength()) {
+    _display->drawVLine(x, _regionY + 2, _inputAreaHeight - 4);
+  } else {
+    _display->drawStr(x, baseline, "_");
+  }
 }
 
 void OLEDKeyboard::_drawInputArea() {
+  TIME_STAGE(STAGE_INPUT_AREA);
   // Draw input frame
-  _display->drawFrame(0, 0, _screenWidth, _inputAreaHeight);
+  int top = _regionY;
+  _display->drawFrame(_regionX, top, _regionWidth, _inputAreaHeight);
+  
+  int cursor = _gapStart;
+  int slot = _selectedKeyIndex - KEY_COUNT;
+  int suggestions = _suggestionCount();
+  
+  // Show the selected suggestion, or the first one as a hint
+  char suffix[OLEDKEYBOARD_MAX_LENGTH + 1];
+  suffix[0] = '\0';
+  if (suggestions > 0) {
+    _suggestionSuffix((slot >= 0 && slot < suggestions) ? slot : 0, suffix, sizeof(suffix));
+  }
+  
+  // Edit tag on the right while an edit entry is selected (inverted)
+  // or its mode is active (framed)
+  int baseline = top + (_inputAreaHeight + _inputAscent + 1) / 2;
+  int textRight = _regionX + _regionWidth - 2;
+  uint8_t tagMode = (_editMode != EDIT_NONE) ? _editMode : _extraMode(slot);
+  if (tagMode != EDIT_NONE) {
+    const char* tag = (tagMode == EDIT_CURSOR) ? "<>" : "Undo";
+    int tagWidth = _stringWidth(tag) + 2;
+    textRight -= tagWidth + 1;
+    if (_editMode != EDIT_NONE) {
+      _display->drawFrame(textRight + 1, top + 2, tagWidth, _inputAreaHeight - 4);
+      _display->drawStr(textRight + 2, baseline, tag);
+    } else {
+      _display->drawBox(textRight + 1, top + 2, tagWidth, _inputAreaHeight - 4);
+      _display->setDrawColor(0);
+      _display->drawStr(textRight + 2, baseline, tag);
+      _display->setDrawColor(1);
+    }
+  }
+  
+  int suffixWidth = _stringWidth(suffix);
+  int x = _regionX + 2;
+#if OLEDKEYBOARD_SCROLLING
+  // Scroll so the cursor (or the end of the suggestion) stays visible,
+  // with "..." marking text hidden on the left. Widths come from the
+  // cached offsets, and the window only moves a character at a time.
+  int ellipsisWidth = _stringWidth("...");
+  int caretWidth = _stringWidth("_");
+  int length = _textLength();
+  int width = textRight - x;
+  int end = _textWidth + suffixWidth + caretWidth;
+  int focusLeft = _cursorOffset;
+  int focusRight = (suffix[0] != '\0') ? end - caretWidth : (cursor < length) ? _cursorOffset + 1 : end;
   
-  // Prepare text to display with scrolling
-  String displayText = _inputText;
-  int fontWidth = 6;
-  int maxChars = (_screenWidth - 4) / fontWidth;
+  if (end <= width) {
+    _scrollStart = 0;
+    _scrollOffset = 0;
+  } else {
+    // Back to the cursor, or as far as the end of the text allows
+    while (_scrollStart > 0) {
+      int previous = _scrollStart - 1;
+      while (previous > 0 && isContinuation(_charAt(previous))) {
+        previous--;
+      }
+      int previousOffset = _scrollOffset - _glyphWidth(previous);
+      if (_scrollOffset <= focusLeft && end - previousOffset > width - ellipsisWidth) {
+        break;
+      }
+      _scrollStart = previous;
+      _scrollOffset = previousOffset;
+    }
+    // Forward until the focus fits
+    while (_scrollStart < length && focusRight - _scrollOffset > width - ellipsisWidth) {
+      _scrollOffset += _glyphWidth(_scrollStart);
+      _scrollStart += utf8Size(_charAt(_scrollStart));
+    }
+  }
   
-  if (displayText.length() > maxChars) {
-    displayText = "..." + displayText.substring(displayText.length() - maxChars + 3);
+  if (_scrollStart > 0) {
+    _display->drawStr(x, baseline, "...");
+    x += ellipsisWidth;
+  }
+#endif
+
+  _textX = x;
+  _display->setClipWindow(x, top + 1, textRight + 1, top + _inputAreaHeight - 1);
+  _drawVisibleText(x, baseline);
+  
+  // The last typed character of masked text is shown for a moment
+  _revealX = -1;
+  if (_masked && _revealing && cursor > 0) {
+    char glyph[5];
+    // A UTF-8 character has at most 3 continuation bytes; stray ones
+    // from a custom layout must not run past the glyph buffer
+    int start = cursor - 1;
+    while (start > 0 && cursor - start < 4 && isContinuation(_text[start])) {
+      start--;
+    }
+    memcpy(glyph, _text + start, cursor - start);
+    glyph[cursor - start] = '\0';
+    
+    int starWidth = _advance['*' - 32];
+    int glyphWidth = _display->getUTF8Width(glyph);
+    _revealX = x + _cursorOffset - _scrollOffset - starWidth;
+    _revealWidth = (glyphWidth > starWidth) ? glyphWidth : starWidth;
+    _display->setDrawColor(0);
+    _display->drawBox(_revealX, top + 2, starWidth, _inputAreaHeight - 4);
+    _display->setDrawColor(1);
+    _display->drawUTF8(_revealX, baseline, glyph);
   }
   
-  // Draw text
-  _display->drawStr(2, 11, displayText.c_str());
+  if (suffix[0] != '\0') {
+    // Then the suggestion (inverted if selected, else underlined)
+    int suffixX = x + _textWidth - _scrollOffset;
+    if (slot >= 0 && slot < suggestions) {
+      _display->drawBox(suffixX, top + 2, suffixWidth + 1, _inputAreaHeight - 4);
+      _display->setDrawColor(0);
+      _display->drawUTF8(suffixX, baseline, suffix);
+      _display->setDrawColor(1);
+    } else {
+      _display->drawUTF8(suffixX, baseline, suffix);
+      _display->drawHLine(suffixX, baseline + 1, suffixWidth);
+    }
+  }
   
-  // Draw cursor
-  if (_cursorVisible && !_inputComplete) {
-    int textWidth = _display->getStrWidth(displayText.c_str());
-    if (textWidth < _screenWidth - 8) {
-      _display->drawStr(2 + textWidth, 11, "_");
+  // Draw cursor (steady while it is being moved, so only a blinking
+  // one is remembered)
+  _cursorX = -1;
+  if (suffix[0] == '\0' && !_inputComplete) {
+    int cursorX = x + _cursorOffset - _scrollOffset;
+    if (_editMode == EDIT_NONE) {
+      _cursorX = cursorX;
+    }
+    if (_cursorVisible || _editMode != EDIT_NONE) {
+      _drawCursor(cursorX, baseline);
     }
   }
+  _clipToRegion();
 }
 
 void OLEDKeyboard::_drawKeyboard() {
+  TIME_STAGE(STAGE_KEYBOARD);
   const char* const* currentKeys = _getCurrentKeys();
   
+  // Label widths are only measured when the layer or key font changes
+  if (currentKeys != _labelKeys) {
+    for (int i = 0; i < KEY_COUNT; i++) {
+      _labelX[i] = (_keyWidth - _display->getUTF8Width(currentKeys[i])) / 2;
+    }
+    _labelKeys = currentKeys;
+  }
+  int labelY = (_keyHeight + _keyAscent + 1) / 2;
+  
   for (int i = 0; i < KEY_COUNT; i++) {
     int row = i / KEY_COLS;
     int col = i % KEY_COLS;
@@ -157,44 +750,244 @@ void OLEDKeyboard::_drawKeyboard() {
     int keyY = _keyboardY + row * (_keyHeight + _vSpacing);
     
     const char* keyLabel = currentKeys[i];
-    int labelWidth = _display->getStrWidth(keyLabel);
-    int labelX = keyX + (_keyWidth - labelWidth) / 2;
-    int labelY = keyY + _keyHeight - 2;
+    int labelX = keyX + _labelX[i];
     
     if (i == _selectedKeyIndex) {
       // Draw selected key (inverted)
       _display->setDrawColor(1);
       _display->drawBox(keyX, keyY, _keyWidth, _keyHeight);
       _display->setDrawColor(0);
-      _display->drawStr(labelX, labelY, keyLabel);
+      _display->drawUTF8(labelX, keyY + labelY, keyLabel);
       _display->setDrawColor(1);
+    } else if (!_isKeyAllowed(keyLabel)) {
+      // Draw unavailable key (label only, skipped by navigation)
+      _display->drawUTF8(labelX, keyY + labelY, keyLabel);
     } else {
       // Draw normal key
       _display->drawFrame(keyX, keyY, _keyWidth, _keyHeight);
-      _display->drawStr(labelX, labelY, keyLabel);
+      _display->drawUTF8(labelX, keyY + labelY, keyLabel);
     }
   }
 }
 
 const char* const* OLEDKeyboard::_getCurrentKeys() const {
-  switch (_currentState) {
-    case STATE_LOWERCASE:
-      return _keysLower;
-    case STATE_SYMBOLS:
-      return _keysSymbols;
-    default:
-      return _keysUpper;
+  return _getKeys(_currentState);
+}
+
+const char* const* OLEDKeyboard::_getKeys(KeyboardState state) const {
+  if (state == STATE_FREQUENT) {
+    return _keysFrequent;
   }
+  return _layouts[state];
 }
 
 void OLEDKeyboard::_processKeyPress(const char* key) {
+  if (_frequentLayer) {
+    _recordUsage(key);
+  }
+  
   if (_isSpecialKey(key)) {
     _handleSpecialKey(key);
   } else {
     // Regular character
-    if (_inputText.length() < _maxInputLength) {
-      _inputText += key;
+    if (_enterChar(key)) {
+      // The usage-ordered layer is laid out around the first key
+      if (_currentState == STATE_FREQUENT) {
+        _selectedKeyIndex = 0;
+      }
+      _selectPredictedKey(key[0]);
+    }
+  }
+}
+
+int OLEDKeyboard::_textLength() const {
+  return _gapStart + (OLEDKEYBOARD_MAX_LENGTH - _gapEnd);
+}
+
+char OLEDKeyboard::_charAt(int index) const {
+  return (index < _gapStart) ? _text[index] : _text[index + (_gapEnd - _gapStart)];
+}
+
+bool OLEDKeyboard::_insertChar(char c) {
+  // Insertion at the cursor only fills the gap
+  if (_gapStart == _gapEnd) {
+    return false;
+  }
+  _text[_gapStart++] = c;
+  if (!isContinuation(c)) {
+    _charCount++;
+  }
+  return true;
+}
+
+bool OLEDKeyboard::_deleteChar() {
+  if (_gapStart == 0) {
+    return false;
+  }
+  if (!isContinuation(_text[--_gapStart])) {
+    _charCount--;
+  }
+  return true;
+}
+
+void OLEDKeyboard::_moveCursor(int step) {
+  // Moving the cursor carries one character (all of its bytes) across
+  // the gap per step
+  _revealing = false;
+  while (step < 0 && _gapStart > 0) {
+    do {
+      _text[--_gapEnd] = _text[--_gapStart];
+    } while (_gapStart > 0 && isContinuation(_text[_gapEnd]));
+    _cursorOffset -= _glyphWidth(_gapStart);
+    step++;
+  }
+  while (step > 0 && _gapEnd < OLEDKEYBOARD_MAX_LENGTH) {
+    _cursorOffset += _glyphWidth(_gapStart);
+    do {
+      _text[_gapStart++] = _text[_gapEnd++];
+    } while (_gapEnd < OLEDKEYBOARD_MAX_LENGTH && isContinuation(_text[_gapEnd]));
+    step--;
+  }
+  _resyncDictionary();
+}
+
+void OLEDKeyboard::_moveGap(int position) {
+  while (_gapStart > position) {
+    _text[--_gapEnd] = _text[--_gapStart];
+  }
+  while (_gapStart < position && _gapEnd < OLEDKEYBOARD_MAX_LENGTH) {
+    _text[_gapStart++] = _text[_gapEnd++];
+  }
+}
+
+int OLEDKeyboard::_glyphWidth(int index) const {
+  // Width of the character starting at index
+  if (_masked) {
+    return _advance['*' - 32];
+  }
+  char glyph[5];
+  int size = utf8Size(_charAt(index));
+  int length = _textLength();
+  int count = 0;
+  while (count < size && index + count < length) {
+    glyph[count] = _charAt(index + count);
+    count++;
+  }
+  glyph[count] = '\0';
+  return _stringWidth(glyph);
+}
+
+int OLEDKeyboard::_stringWidth(const char* text) const {
+  // Sum of glyph advances: ASCII from the table cached by setFont(),
+  // anything else looked up in the font
+  int width = 0;
+  const uint8_t* previous = NULL;
+  bool switched = false;
+  while (*text != '\0') {
+    uint8_t lead = *text;
+    if (lead < 0x80) {
+      width += (lead >= 32 && lead < 127) ? _advance[lead - 32] : 0;
+      text++;
+      continue;
+    }
+    
+    int size = utf8Size(lead);
+    uint16_t encoding = (size == 2) ? (lead & 0x1F) : (lead & 0x0F);
+    for (int i = 1; i < size; i++) {
+      if (!isContinuation(text[i])) {
+        size = i;
+        break;
+      }
+      encoding = (encoding << 6) | (text[i] & 0x3F);
+    }
+    // U8g2 fonts only cover the basic multilingual plane
+    if (size > 1 && size < 4) {
+      if (!switched) {
+        previous = _useFont(_inputFont);
+        switched = true;
+      }
+      width += u8g2_GetGlyphWidth(_display->getU8g2(), encoding);
+    }
+    text += size;
+  }
+  if (switched) {
+    _useFont(previous);
+  }
+  return width;
+}
+
+const uint8_t* OLEDKeyboard::_useFont(const uint8_t* font) const {
+  const uint8_t* previous = _display->getU8g2()->font;
+  if (font != NULL && font != previous) {
+    _display->setFont(font);
+  }
+  return previous;
+}
+
+void OLEDKeyboard::_measureText() {
+  // Full rescan, only needed after a font change, undo or redo
+  int length = _textLength();
+  _revealing = false;
+  while (_scrollStart > 0 && (_scrollStart >= length || isContinuation(_charAt(_scrollStart)))) {
+    _scrollStart--;
+  }
+  _textWidth = 0;
+  _cursorOffset = 0;
+  _scrollOffset = 0;
+  for (int i = 0; i < length; i += utf8Size(_charAt(i))) {
+    if (i == _scrollStart) {
+      _scrollOffset = _textWidth;
+    }
+    if (i == _gapStart) {
+      _cursorOffset = _textWidth;
     }
+    _textWidth += _glyphWidth(i);
+  }
+  if (_gapStart >= length) {
+    _cursorOffset = _textWidth;
+  }
+}
+
+void OLEDKeyboard::_clearText() {
+  // Wipe the text and the journal, which may hold a password
+  memset(_text, 0, sizeof(_text));
+  memset(_journal, 0, sizeof(_journal));
+  _revealing = false;
+  _gapStart = 0;
+  _gapEnd = OLEDKEYBOARD_MAX_LENGTH;
+  _charCount = 0;
+  _textWidth = 0;
+  _cursorOffset = 0;
+  _scrollStart = 0;
+  _scrollOffset = 0;
+  _editMode = EDIT_NONE;
+  _journalHead = 0;
+  _undoCount = 0;
+  _redoCount = 0;
+}
+
+void OLEDKeyboard::_recordEdit(uint8_t kind, int position, char c) {
+  if (_journalBulk && kind != JOURNAL_BULK) {
+    return;                          // Recorded as one once inserted
+  }
+  JournalEntry& entry = _journal[_journalHead];
+  entry.position = position;
+  entry.c = c;
+  entry.flags = kind | (_journalChain ? JOURNAL_CHAINED : 0);
+  
+  // The oldest record is overwritten once the ring is full
+  _journalHead = (_journalHead + 1) % OLEDKEYBOARD_UNDO_DEPTH;
+  if (_undoCount < OLEDKEYBOARD_UNDO_DEPTH) {
+    _undoCount++;
+  }
+  _redoCount = 0;
+  
+  // Drop what is left of a chain whose first record was overwritten, so
+  // undo never splits a character
+  int oldest = (_journalHead + OLEDKEYBOARD_UNDO_DEPTH - _undoCount) % OLEDKEYBOARD_UNDO_DEPTH;
+  while (_undoCount > 0 && (_journal[oldest].flags & JOURNAL_CHAINED)) {
+    oldest = (oldest + 1) % OLEDKEYBOARD_UNDO_DEPTH;
+    _undoCount--;
   }
 }
 
@@ -208,91 +1001,1306 @@ bool OLEDKeyboard::_isSpecialKey(const char* key) const {
 
 void OLEDKeyboard::_handleSpecialKey(const char* key) {
   if (strcmp(key, ">") == 0) {
-    // Enter/Go
-    _inputComplete = true;
+    // Enter/Go (only once the input satisfies the profile)
+    if (isInputValid()) {
+      _addHistory();
+      _inputComplete = true;
+    }
   } else if (strcmp(key, "<") == 0) {
-    // Backspace
-    if (_inputText.length() > 0) {
-      _inputText.remove(_inputText.length() - 1);
+    // Backspace (deletes before the cursor)
+    if (_eraseChar()) {
+      _resyncDictionary();
     }
   } else if (strcmp(key, "_") == 0) {
     // Space
-    if (_inputText.length() < _maxInputLength) {
-      _inputText += " ";
+    if (_enterChar(" ")) {
+      _selectPredictedKey(' ');
     }
-  } else if (strcmp(key, "Aa") == 0) {
-    // Shift (toggle between uppercase and lowercase)
-    _currentState = (_currentState == STATE_UPPERCASE) ? STATE_LOWERCASE : STATE_UPPERCASE;
-  } else if (strcmp(key, "?#") == 0) {
-    // Symbols toggle
-    _currentState = (_currentState == STATE_SYMBOLS) ? STATE_LOWERCASE : STATE_SYMBOLS;
+  } else if (strcmp(key, "Aa") == 0 || strcmp(key, "?#") == 0) {
+    // Shift or symbols toggle
+    _currentState = _layerAfter(key);
+    _moveSelection(0);
   }
 }
 
-void OLEDKeyboard::_calculateLayout() {
-  _keyboardX = (_screenWidth - (KEY_COLS * _keyWidth + (KEY_COLS - 1) * _hSpacing)) / 2;
-  _keyboardY = _inputAreaHeight;
-}
-
-// Public interface methods
-bool OLEDKeyboard::isInputComplete() const {
-  return _inputComplete;
+KeyboardState OLEDKeyboard::_layerAfter(const char* key) const {
+  if (strcmp(key, "Aa") == 0) {
+    // Shift (toggle between uppercase and lowercase)
+    return (_currentState == STATE_UPPERCASE) ? STATE_LOWERCASE : STATE_UPPERCASE;
+  }
+  // Symbols toggle (back to the usage-ordered layer if enabled)
+  if (_currentState == STATE_SYMBOLS) {
+    return _frequentLayer ? STATE_FREQUENT : STATE_LOWERCASE;
+  }
+  return STATE_SYMBOLS;
 }
 
-String OLEDKeyboard::getInputText() const {
-  return _inputText;
+void OLEDKeyboard::_moveSelection(int step) {
+  const char* const* currentKeys = _getCurrentKeys();
+  int slots = _extraCount();
+  int ringSize = KEY_COUNT + slots;
+  int index = _selectedKeyIndex;
+  
+  // Suggestions may have gone away since the entry was selected
+  if (index >= ringSize) {
+    index = (slots > 0) ? ringSize - 1 : 0;
+  }
+  
+  // A zero step only moves off the current key if it is not allowed
+  if (step == 0) {
+    if (index >= KEY_COUNT || _isKeyAllowed(currentKeys[index])) {
+      _selectedKeyIndex = index;
+      return;
+    }
+    step = 1;
+  }
+  
+  // Suggestions and the edit entry sit between the last and the first
+  // key, best suggestion first when moving up. Enter and backspace are
+  // always allowed, so this always terminates.
+  int pos = (index < KEY_COUNT) ? index : ringSize - 1 - (index - KEY_COUNT);
+  for (int i = 0; i < ringSize; i++) {
+    pos = (pos + step + ringSize) % ringSize;
+    if (pos >= KEY_COUNT) {
+      index = KEY_COUNT + (ringSize - 1 - pos);
+      break;
+    }
+    if (_isKeyAllowed(currentKeys[pos])) {
+      index = pos;
+      break;
+    }
+  }
+  _selectedKeyIndex = index;
 }
 
-void OLEDKeyboard::clearInput() {
-  _inputText = "";
-  _inputComplete = false;
+int OLEDKeyboard::_extraCount() const {
+  // Suggestions, the cursor entry once there is text to edit and the
+  // undo entry once there is something to undo or redo
+  return _suggestionCount() + (_textLength() > 0 ? 1 : 0) +
+         (_undoCount > 0 || _redoCount > 0 ? 1 : 0);
 }
 
-void OLEDKeyboard::reset() {
-  _currentState = STATE_UPPERCASE;
-  _selectedKeyIndex = 0;
-  _inputText = "";
-  _inputComplete = false;
-  _cursorVisible = true;
-  _lastCursorBlink = 0;
+uint8_t OLEDKeyboard::_extraMode(int index) const {
+  int suggestions = _suggestionCount();
+  if (index < suggestions || index >= _extraCount()) {
+    return EDIT_NONE;
+  }
+  return (index == suggestions && _textLength() > 0) ? EDIT_CURSOR : EDIT_UNDO;
 }
 
-void OLEDKeyboard::setMaxLength(int maxLen) {
-  if (maxLen > 0) {
-    _maxInputLength = maxLen;
+void OLEDKeyboard::_selectExtra(int index) {
+  if (index < _suggestionCount()) {
+    _acceptSuggestion(index);
+  } else {
+    _editMode = _extraMode(index);
   }
 }
 
-void OLEDKeyboard::setPosition(int x, int y) {
-  _keyboardX = x;
-  _keyboardY = y;
+bool OLEDKeyboard::_enterChar(const char* c) {
+  int size = utf8Size(c[0]);
+  for (int i = 1; i < size; i++) {
+    if (!isContinuation(c[i])) {
+      return false;                  // Truncated sequence
+    }
+  }
+  if (_charCount >= _maxInputLength || _gapEnd - _gapStart < size || !_acceptsChar(c[0])) {
+    return false;
+  }
+  if (_keyPrediction == PREDICT_LEARNED && _gapStart > 0) {
+    _learnBigram(_text[_gapStart - 1], c[0]);
+  }
+  
+  // All bytes of the character are undone together
+  int position = _gapStart;
+  bool chain = _journalChain;
+  for (int i = 0; i < size; i++) {
+    _recordEdit(JOURNAL_INSERT, _gapStart, c[i]);
+    _insertChar(c[i]);
+    _journalChain = true;
+  }
+  _journalChain = chain;
+  
+  _revealing = _masked && _revealTime > 0;
+  _revealStart = _clock();
+  
+  int width = _glyphWidth(position);
+  _textWidth += width;
+  _cursorOffset += width;
+  if (position < _scrollStart) {
+    _scrollStart += size;
+    _scrollOffset += width;
+  }
+  _advanceDictionary(c[0]);
+  return true;
 }
 
-void OLEDKeyboard::setDebounceDelay(unsigned long delay) {
-  _debounceDelay = delay;
+bool OLEDKeyboard::_eraseChar() {
+  if (_gapStart == 0) {
+    return false;
+  }
+  
+  int position = _gapStart - 1;
+  while (position > 0 && isContinuation(_text[position])) {
+    position--;
+  }
+  int width = _glyphWidth(position);
+  _revealing = false;
+  if (_gapStart <= _scrollStart) {
+    _scrollStart -= _gapStart - position;
+    _scrollOffset -= width;
+  }
+  
+  // Bytes are removed last to first and restored as one chain
+  bool chain = _journalChain;
+  while (_gapStart > position) {
+    _recordEdit(JOURNAL_DELETE, _gapStart - 1, _text[_gapStart - 1]);
+    _deleteChar();
+    _journalChain = true;
+  }
+  _journalChain = chain;
+  
+  _textWidth -= width;
+  _cursorOffset -= width;
+  return true;
+}
+
+void OLEDKeyboard::_advanceDictionary(char c) {
+  if (_dictionary == NULL) {
+    return;
+  }
+  
+  // A space starts a new word at the root
+  if (c == ' ') {
+    _dictNode = 0;
+    _dictDepth = 0;
+    return;
+  }
+  
+  if (_dictDepth < 255) {
+    _dictDepth++;
+  }
+  if (_dictNode == NO_NODE) {
+    return;
+  }
+  
+  // Follow the matching child of the previous node
+  uint8_t children = dictByte(_dictionary, _dictNode);
+  uint16_t entry = _dictNode + 2 + 2 * dictByte(_dictionary, _dictNode + 1);
+  char target = (c & 0x80) ? c : tolower(c);
+  
+  _dictNode = NO_NODE;
+  for (uint8_t i = 0; i < children; i++, entry += 3) {
+    if (dictByte(_dictionary, entry) == (uint8_t)target) {
+      _dictNode = dictOffset(_dictionary, entry + 1);
+      break;
+    }
+  }
+}
+
+void OLEDKeyboard::_resyncDictionary() {
+  // Walk the word before the cursor again (after deletions or moves)
+  _dictNode = 0;
+  _dictDepth = 0;
+  
+  int start = _gapStart;
+  while (start > 0 && _text[start - 1] != ' ') {
+    start--;
+  }
+  for (int i = start; i < _gapStart; i++) {
+    _advanceDictionary(_text[i]);
+  }
+}
+
+void OLEDKeyboard::_acceptCompletion(int index) {
+  if (index < 0 || index >= getCompletionCount()) {
+    return;
+  }
+  
+  uint16_t word = dictOffset(_dictionary, _dictNode + 2 + 2 * index) + _dictDepth;
+  char c[2] = { (char)dictByte(_dictionary, word), '\0' };
+  int position = _beginBulkInsert();
+  while (c[0] != '\0' && _enterChar(c)) {
+    c[0] = dictByte(_dictionary, ++word);
+  }
+  _endBulkInsert(position);
+}
+
+int OLEDKeyboard::_beginBulkInsert() {
+  // The inserted characters are undone as one record, however many bytes
+  // they take, so a long insert cannot push itself out of the journal
+  _journalBulk = true;
+  return _gapStart;
+}
+
+void OLEDKeyboard::_endBulkInsert(int position) {
+  _journalBulk = false;
+  if (_gapStart > position) {
+    _recordEdit(JOURNAL_BULK, position, _gapStart - position);
+  }
+}
+
+int OLEDKeyboard::_suggestionCount() const {
+  // None for masked input, which would otherwise be matched against
+  // and copied out of the history, or with the cursor inside the text,
+  // where they would be inserted before the rest of it
+  if (_masked || _gapEnd != OLEDKEYBOARD_MAX_LENGTH) {
+    return 0;
+  }
+  
+  // Word completions take precedence, otherwise matching history entries
+  int count = getCompletionCount();
+  if (count > 0) {
+    return count;
+  }
+  while (count < MAX_HISTORY_SLOTS && _historyEntry(count) >= 0) {
+    count++;
+  }
+  return count;
+}
+
+void OLEDKeyboard::_suggestionSuffix(int index, char* buffer, size_t size) const {
+  size_t length = 0;
+  if (getCompletionCount() > 0) {
+    // The completion after the characters typed of the current word
+    if (index >= 0 && index < getCompletionCount()) {
+      uint16_t word = dictOffset(_dictionary, _dictNode + 2 + 2 * index);
+      int skip = _dictDepth;
+      for (char c = dictByte(_dictionary, word); c != '\0' && length + 1 < size; c = dictByte(_dictionary, ++word)) {
+        if (skip > 0) {
+          skip--;
+        } else {
+          buffer[length++] = c;
+        }
+      }
+    }
+  } else {
+    // History entries extend the typed text
+    int entry = _historyEntry(index);
+    if (entry >= 0) {
+      const char* text = (const char*)&_history[entry + 1 + _gapStart];
+      while (text[length] != '\0' && length + 1 < size) {
+        buffer[length] = text[length];
+        length++;
+      }
+    }
+  }
+  buffer[length] = '\0';
+}
+
+void OLEDKeyboard::_acceptSuggestion(int index) {
+  if (getCompletionCount() > 0) {
+    _acceptCompletion(index);
+    return;
+  }
+  
+  char suffix[OLEDKEYBOARD_MAX_LENGTH + 1];
+  _suggestionSuffix(index, suffix, sizeof(suffix));
+  int position = _beginBulkInsert();
+  for (int i = 0; suffix[i] != '\0'; i += utf8Size(suffix[i])) {
+    if (!_enterChar(suffix + i)) {
+      break;
+    }
+  }
+  _endBulkInsert(position);
+}
+
+int OLEDKeyboard::_nextHistoryEntry(int offset) const {
+  // Skip profile byte, text and terminator; -1 past the last entry
+  offset += 1 + strlen((const char*)&_history[offset + 1]) + 1;
+  if (offset >= OLEDKEYBOARD_HISTORY_SIZE - 1 || _history[offset] == 0xFF) {
+    return -1;
+  }
+  return offset;
+}
+
+int OLEDKeyboard::_historyEntry(int index) const {
+  // Offset of the index-th entry for this profile that extends the text
+  // (only offered with the cursor at the end)
+  if (_history[0] == 0xFF || _gapEnd != OLEDKEYBOARD_MAX_LENGTH) {
+    return -1;
+  }
+  
+  const char* typed = _text;
+  int typedLength = _gapStart;
+  for (int offset = 0; offset >= 0; offset = _nextHistoryEntry(offset)) {
+    const char* text = (const char*)&_history[offset + 1];
+    if (_history[offset] == _inputProfile && (int)strlen(text) > typedLength &&
+        strncmp(text, typed, typedLength) == 0) {
+      if (index-- == 0) {
+        return offset;
+      }
+    }
+  }
+  return -1;
+}
+
+void OLEDKeyboard::_addHistory() {
+  // Masked input is never kept; the rest is copied straight out of the
+  // gap buffer (before and after the gap)
+  int length = _textLength();
+  int size = length + 2;
+  int after = OLEDKEYBOARD_MAX_LENGTH - _gapEnd;
+  if (_masked || length == 0 || size > OLEDKEYBOARD_HISTORY_SIZE) {
+    return;
+  }
+  
+  // Drop an older copy of the same entry
+  if (_history[0] != 0xFF) {
+    for (int offset = 0; offset >= 0; offset = _nextHistoryEntry(offset)) {
+      const char* entry = (const char*)&_history[offset + 1];
+      if (_history[offset] == _inputProfile && strlen(entry) == (size_t)length &&
+          memcmp(entry, _text, _gapStart) == 0 && memcmp(entry + _gapStart, _text + _gapEnd, after) == 0) {
+        memmove(&_history[offset], &_history[offset + size], OLEDKEYBOARD_HISTORY_SIZE - offset - size);
+        memset(&_history[OLEDKEYBOARD_HISTORY_SIZE - size], 0xFF, size);
+        break;
+      }
+    }
+  }
+  
+  // Make room at the front, then cut off the entry that no longer fits
+  memmove(&_history[size], &_history[0], OLEDKEYBOARD_HISTORY_SIZE - size);
+  _history[0] = _inputProfile;
+  memcpy(&_history[1], _text, _gapStart);
+  memcpy(&_history[1 + _gapStart], _text + _gapEnd, after);
+  _history[1 + length] = '\0';
+  _trimHistory();
+}
+
+void OLEDKeyboard::_trimHistory() {
+  // Mark everything after the last complete entry as unused
+  int offset = 0;
+  while (offset < OLEDKEYBOARD_HISTORY_SIZE && _history[offset] != 0xFF) {
+    int end = offset + 1;
+    while (end < OLEDKEYBOARD_HISTORY_SIZE && _history[end] != '\0') {
+      end++;
+    }
+    if (end >= OLEDKEYBOARD_HISTORY_SIZE) {
+      break;
+    }
+    offset = end + 1;
+  }
+  if (offset < OLEDKEYBOARD_HISTORY_SIZE) {
+    memset(&_history[offset], 0xFF, OLEDKEYBOARD_HISTORY_SIZE - offset);
+  }
+}
+
+bool OLEDKeyboard::_isKeyAllowed(const char* key) const {
+#if !OLEDKEYBOARD_SYMBOLS
+  if (_layouts[STATE_SYMBOLS] == NULL && strcmp(key, "?#") == 0) {
+    return false;                    // No symbols layer to switch to
+  }
+#endif
+  if (_inputProfile == PROFILE_TEXT) {
+    return true;
+  }
+  
+  if (strcmp(key, "Aa") == 0 || strcmp(key, "?#") == 0) {
+    // Layer switches are only useful if they lead somewhere usable
+    KeyboardState target = _layerAfter(key);
+    return target != _currentState && (_allowedLayers & (1 << target));
+  }
+  
+  if (_isSpecialKey(key)) {
+    return strcmp(key, "_") != 0;   // No spaces outside free text
+  }
+  
+  return _isCharAllowed(key[0]);
+}
+
+bool OLEDKeyboard::_isCharAllowed(char c) const {
+  // Characters outside ASCII are only accepted as free text
+  if (c & 0x80) {
+    return _inputProfile == PROFILE_TEXT;
+  }
+  
+  switch (_inputProfile) {
+    case PROFILE_NUMERIC:
+      return isdigit(c);
+    case PROFILE_HEX:
+      return isxdigit(c);
+    case PROFILE_IPV4:
+      return isdigit(c) || c == '.';
+    case PROFILE_HOSTNAME:
+      return isalnum(c) || c == '-' || c == '.';
+    default:
+      return true;
+  }
+}
+
+bool OLEDKeyboard::_acceptsChar(char c) const {
+  if (!_isCharAllowed(c)) {
+    return false;
+  }
+  if (_inputProfile != PROFILE_IPV4 && _inputProfile != PROFILE_HOSTNAME) {
+    return true;
+  }
+  
+  // Only the dot-separated segment around the cursor matters
+  int length = _textLength();
+  int cursor = _gapStart;
+  int before = 0;
+  while (before < cursor && _charAt(cursor - 1 - before) != '.') {
+    before++;
+  }
+  int after = 0;
+  while (cursor + after < length && _charAt(cursor + after) != '.') {
+    after++;
+  }
+  char previous = (cursor > 0) ? _charAt(cursor - 1) : '\0';
+  char next = (cursor < length) ? _charAt(cursor) : '\0';
+  
+  if (c == '.') {
+    // Splits the segment, both halves must remain valid
+    if (before == 0 || next == '.') {
+      return false;
+    }
+    if (_inputProfile == PROFILE_IPV4) {
+      int dots = 0;
+      for (int i = 0; i < length; i++) {
+        if (_charAt(i) == '.') {
+          dots++;
+        }
+      }
+      return dots < 3 && (after < 2 || next != '0');
+    }
+    return previous != '-' && next != '-';
+  }
+  
+  if (_inputProfile == PROFILE_IPV4) {
+    // At most three digits per octet, no leading zeros, value <= 255
+    // (a deleted dot can leave a longer run)
+    if (before + after >= 3) {
+      return false;
+    }
+    int start = cursor - before;
+    int octet = 0;
+    for (int i = 0; i <= before + after; i++) {
+      char digit = (i < before) ? _charAt(start + i) : (i == before) ? c : _charAt(start + i - 1);
+      if (i == 0 && digit == '0' && before + after > 0) {
+        return false;
+      }
+      octet = octet * 10 + (digit - '0');
+    }
+    return octet <= 255;
+  }
+  
+  // Hostname labels are 1-63 characters and cannot start or end with '-'
+  if (before + after >= 63) {
+    return false;
+  }
+  return c != '-' || before > 0;
+}
+
+int OLEDKeyboard::_bigramIndex(char c) const {
+  if (c & 0x80) {
+    return -1;                       // Not on the built-in layouts
+  }
+  if (isalpha(c)) {
+    return tolower(c) - 'a';
+  }
+  
+  // Everything else is identified by its key on the symbols layer
+  for (int i = 0; i < KEY_COUNT; i++) {
+    const char* key = SLOT_KEYS[i];
+    if ((c == ' ' && strcmp(key, "_") == 0) || (key[0] == c && key[1] == '\0')) {
+      return 26 + i;
+    }
+  }
+  return -1;
+}
+
+char OLEDKeyboard::_predictNextChar(char c) const {
+  if (_keyPrediction == PREDICT_LEARNED) {
+    int index = _bigramIndex(c);
+    if (index >= 0 && _learnedNext[index] != 0) {
+      return _learnedNext[index] & 0x7F;
+    }
+  }
+  
+  // Static table (also the fallback until something has been learned)
+  if (!(c & 0x80) && isalpha(c)) {
+    return pgm_read_byte(&_nextLetter[tolower(c) - 'a']);
+  }
+  return '\0';
+}
+
+void OLEDKeyboard::_learnBigram(char previous, char next) {
+  int index = _bigramIndex(previous);
+  if (index < 0 || (next & 0x80)) {
+    return;
+  }
+  
+  // One byte per entry: a prediction is only replaced after it misses
+  // twice in a row, so a single odd word does not undo a common pattern
+  uint8_t entry = _learnedNext[index];
+  char predicted = entry & 0x7F;
+  if (isalpha(next)) {
+    next = tolower(next);
+  }
+  
+  if (predicted == next) {
+    _learnedNext[index] = next | 0x80;
+  } else if (entry & 0x80) {
+    _learnedNext[index] = predicted;
+  } else {
+    _learnedNext[index] = next;
+  }
+}
+
+void OLEDKeyboard::_selectPredictedKey(char c) {
+  if (_keyPrediction == PREDICT_OFF) {
+    return;
+  }
+  
+  char next = _predictNextChar(c);
+  if (next == '\0') {
+    return;
+  }
+  
+  // Only jump within the current layer; letters follow its case
+  if (isalpha(next)) {
+    next = (_currentState == STATE_UPPERCASE) ? toupper(next) : tolower(next);
+  }
+  const char* const* currentKeys = _getCurrentKeys();
+  for (int i = 0; i < KEY_COUNT; i++) {
+    const char* key = currentKeys[i];
+    bool match = (next == ' ') ? strcmp(key, "_") == 0
+                               : (key[0] == next && key[1] == '\0');
+    if (match && _isKeyAllowed(key)) {
+      _selectedKeyIndex = i;
+      return;
+    }
+  }
+}
+
+KeyboardState OLEDKeyboard::_profileLayer() const {
+  switch (_inputProfile) {
+    case PROFILE_NUMERIC:
+    case PROFILE_HEX:
+    case PROFILE_IPV4:
+#if !OLEDKEYBOARD_SYMBOLS
+      if (_layouts[STATE_SYMBOLS] == NULL) {
+        return STATE_LOWERCASE;
+      }
+#endif
+      return STATE_SYMBOLS;
+    case PROFILE_HOSTNAME:
+      return _frequentLayer ? STATE_FREQUENT : STATE_LOWERCASE;
+    default:
+      return _frequentLayer ? STATE_FREQUENT : STATE_UPPERCASE;
+  }
+}
+
+int OLEDKeyboard::_keySlot(const char* key) const {
+  if (key[1] == '\0') {
+    return _bigramIndex(key[0]);
+  }
+  
+  // Multi-character labels (layer switches) live on the symbols layer
+  for (int i = 0; i < KEY_COUNT; i++) {
+    if (strcmp(key, SLOT_KEYS[i]) == 0) {
+      return 26 + i;
+    }
+  }
+  return -1;
+}
+
+const char* OLEDKeyboard::_slotLabel(int slot) const {
+  if (slot >= 26) {
+    const char* key = SLOT_KEYS[slot - 26];
+    return (isalpha(key[0]) && key[1] == '\0') ? NULL : key; // Letters have their own slots
+  }
+  
+  for (int i = 0; i < KEY_COUNT; i++) {
+    if (_keysLower[i][0] == 'a' + slot && _keysLower[i][1] == '\0') {
+      return _keysLower[i];
+    }
+  }
+  return NULL;
+}
+
+void OLEDKeyboard::_recordUsage(const char* key) {
+  int slot = _keySlot(key);
+  if (slot < 0) {
+    return;
+  }
+  
+  // Halve all counts when one saturates, so recent use weighs more
+  if (_keyUsage[slot] == 255) {
+    for (int i = 0; i < BIGRAM_SLOTS; i++) {
+      _keyUsage[i] >>= 1;
+    }
+  }
+  _keyUsage[slot]++;
+}
+
+void OLEDKeyboard::_buildFrequentLayer() {
+  // Candidates in default priority order, then stably sorted by usage
+  uint8_t order[BIGRAM_SLOTS];
+  for (int i = 0; i < 26; i++) {
+    order[i] = pgm_read_byte(&_letterPriority[i]) - 'a';
+  }
+  for (int i = 26; i < BIGRAM_SLOTS; i++) {
+    order[i] = i;
+  }
+  for (int i = 1; i < BIGRAM_SLOTS; i++) {
+    uint8_t slot = order[i];
+    int j = i;
+    while (j > 0 && _keyUsage[order[j - 1]] < _keyUsage[slot]) {
+      order[j] = order[j - 1];
+      j--;
+    }
+    order[j] = slot;
+  }
+  
+  // Keep the keys needed to finish input or leave the layer, fill the
+  // rest with the most used ones. Ranks alternate around the first key
+  // (0, 1, last, 2, last - 1, ...) to minimise presses in either direction.
+  int essentials = 4;
+  int others = 0;
+  int rank = 0;
+  for (int i = 0; i < BIGRAM_SLOTS && rank < KEY_COUNT; i++) {
+    const char* key = _slotLabel(order[i]);
+    if (key == NULL) {
+      continue;
+    }
+    bool essential = strcmp(key, "Aa") == 0 || strcmp(key, "?#") == 0 ||
+                     strcmp(key, "<") == 0 || strcmp(key, ">") == 0;
+    if (!essential && others == KEY_COUNT - essentials) {
+      continue;
+    }
+    others += essential ? 0 : 1;
+    
+    int position = (rank % 2 == 1) ? (rank + 1) / 2 : (KEY_COUNT - rank / 2) % KEY_COUNT;
+    _keysFrequent[position] = key;
+    rank++;
+  }
+  _labelKeys = NULL;
+  _needsRedraw = true;
+}
+
+
+void OLEDKeyboard::_calculateLayout() {
+  _needsRedraw = true;
+  _keyboardX = _regionX + (_regionWidth - (KEY_COLS * _keyWidth + (KEY_COLS - 1) * _hSpacing)) / 2;
+  _keyboardY = _regionY + _inputAreaHeight;
+}
+
+// Public interface methods
+bool OLEDKeyboard::isInputComplete() const {
+  return _inputComplete;
+}
+
+bool OLEDKeyboard::isIdle() const {
+  return _idle;
+}
+
+size_t OLEDKeyboard::getInputText(char* buffer, size_t size) const {
+  if (size == 0) {
+    return 0;
+  }
+  
+  // Whole characters only, always terminated
+  size_t length = _textLength();
+  if (length > size - 1) {
+    length = size - 1;
+    while (length > 0 && isContinuation(_charAt(length))) {
+      length--;
+    }
+  }
+  for (size_t i = 0; i < length; i++) {
+    buffer[i] = _charAt(i);
+  }
+  buffer[length] = '\0';
+  return length;
+}
+
+String OLEDKeyboard::getInputText() const {
+  String text;
+  int length = _textLength();
+  text.reserve(length);
+  for (int i = 0; i < length; i++) {
+    text += _charAt(i);
+  }
+  return text;
+}
+
+bool OLEDKeyboard::isInputValid() const {
+  if (_inputProfile == PROFILE_TEXT) {
+    return true;
+  }
+  
+  int length = _textLength();
+  if (length == 0) {
+    return false;
+  }
+  if (_inputProfile != PROFILE_IPV4 && _inputProfile != PROFILE_HOSTNAME) {
+    return true;
+  }
+  
+  // Check every dot-separated segment (edits may have emptied one)
+  int segments = 0;
+  int start = 0;
+  for (int i = 0; i <= length; i++) {
+    if (i < length && _charAt(i) != '.') {
+      continue;
+    }
+    int size = i - start;
+    char first = (size > 0) ? _charAt(start) : '\0';
+    char last = (size > 0) ? _charAt(i - 1) : '\0';
+    
+    if (_inputProfile == PROFILE_IPV4) {
+      // Length first, so the octet cannot overflow a 16-bit int
+      if (size == 0 || size > 3 || (size > 1 && first == '0')) {
+        return false;
+      }
+      int octet = 0;
+      for (int j = start; j < i; j++) {
+        octet = octet * 10 + (_charAt(j) - '0');
+      }
+      if (octet > 255) {
+        return false;
+      }
+    } else if (size == 0 || size > 63 || first == '-' || last == '-') {
+      return false;
+    }
+    segments++;
+    start = i + 1;
+  }
+  
+  return _inputProfile != PROFILE_IPV4 || segments == 4;
+}
+
+void OLEDKeyboard::clearInput() {
+  _clearText();
+  _needsRedraw = true;
+  _inputComplete = false;
+  _resyncDictionary();
+}
+
+void OLEDKeyboard::reset() {
+  _wake();
+  _currentState = _profileLayer();
+  _selectedKeyIndex = 0;
+  _clearText();
+  _inputComplete = false;
+  _cursorVisible = true;
+  _lastCursorBlink = _clock() - _cursorBlinkInterval - 1; // Blink due at once
+  _resyncDictionary();
+  if (_frequentLayer) {
+    _buildFrequentLayer();
+  }
+  _moveSelection(0);
+}
+
+bool OLEDKeyboard::undo() {
+  if (_undoCount == 0) {
+    return false;
+  }
+  
+  // Walk back through the chain; each record puts the cursor where the
+  // edit happened
+  bool chained;
+  do {
+    _journalHead = (_journalHead + OLEDKEYBOARD_UNDO_DEPTH - 1) % OLEDKEYBOARD_UNDO_DEPTH;
+    const JournalEntry& entry = _journal[_journalHead];
+    if (entry.flags & JOURNAL_BULK) {
+      _moveGap(entry.position + (uint8_t)entry.c);
+      for (int i = 0; i < (uint8_t)entry.c; i++) {
+        _deleteChar();
+      }
+    } else if (entry.flags & JOURNAL_INSERT) {
+      _moveGap(entry.position + 1);
+      _deleteChar();
+    } else {
+      _moveGap(entry.position);
+      _insertChar(entry.c);
+    }
+    _undoCount--;
+    // A bulk insert's bytes are not kept, so nothing from it on is redone
+    _redoCount = (entry.flags & JOURNAL_BULK) ? 0 : _redoCount + 1;
+    chained = entry.flags & JOURNAL_CHAINED;
+  } while (chained && _undoCount > 0);
+  
+  _measureText();
+  _resyncDictionary();
+  _needsRedraw = true;
+  return true;
+}
+
+bool OLEDKeyboard::redo() {
+  if (_redoCount == 0) {
+    return false;
+  }
+  
+  do {
+    const JournalEntry& entry = _journal[_journalHead];
+    if (entry.flags & JOURNAL_INSERT) {
+      _moveGap(entry.position);
+      _insertChar(entry.c);
+    } else {
+      _moveGap(entry.position + 1);
+      _deleteChar();
+    }
+    _journalHead = (_journalHead + 1) % OLEDKEYBOARD_UNDO_DEPTH;
+    _undoCount++;
+    _redoCount--;
+  } while (_redoCount > 0 && (_journal[_journalHead].flags & JOURNAL_CHAINED));
+  
+  _measureText();
+  _resyncDictionary();
+  _needsRedraw = true;
+  return true;
+}
+
+void OLEDKeyboard::setMaxLength(int maxLen) {
+  if (maxLen > 0) {
+    _maxInputLength = (maxLen < OLEDKEYBOARD_MAX_LENGTH) ? maxLen : OLEDKEYBOARD_MAX_LENGTH;
+  }
+}
+
+void OLEDKeyboard::setPosition(int x, int y) {
+  _keyboardX = x;
+  _keyboardY = y;
+  _needsRedraw = true;
+}
+
+void OLEDKeyboard::setRegion(int x, int y, int width, int height) {
+  if (width > 0 && height > 0) {
+    _regionX = x;
+    _regionY = y;
+    _regionWidth = width;
+    _regionHeight = height;
+    _calculateLayout();
+  }
+}
+
+void OLEDKeyboard::setDebounceDelay(unsigned long delay) {
+  _buttons.setDebounceDelay(delay);
+}
+
+void OLEDKeyboard::setInput(InputSource* input) {
+  _input = (input != NULL) ? input : &_buttons;
+  _input->setClock(_clock);
+}
+
+void OLEDKeyboard::setObserver(InputObserver* observer) {
+  _observer = observer;
+}
+
+#if OLEDKEYBOARD_PROFILE
+void StageStats::reset() {
+  count = 0;
+  min = 0xFFFFFFFFUL;
+  max = 0;
+  total = 0;
+  memset(histogram, 0, sizeof(histogram));
+}
+
+void StageStats::add(uint32_t us) {
+  count++;
+  total += us;
+  min = (us < min) ? us : min;
+  max = (us > max) ? us : max;
+  
+  int bin = 0;
+  while (bin < BINS - 1 && (us >> (bin + 1)) != 0) {
+    bin++;
+  }
+  if (histogram[bin] < 0xFFFF) {
+    histogram[bin]++;
+  }
+}
+
+uint32_t StageStats::average() const {
+  return (count > 0) ? total / count : 0;
+}
+
+void LatencyStats::reset() {
+  count = 0;
+  max = 0;
+  memset(buckets, 0, sizeof(buckets));
+}
+
+void LatencyStats::add(uint32_t us) {
+  count++;
+  max = (us > max) ? us : max;
+  uint32_t bucket = us / BUCKET_US;
+  bucket = (bucket < BUCKETS) ? bucket : BUCKETS - 1;
+  if (buckets[bucket] < 0xFFFF) {
+    buckets[bucket]++;
+  }
+}
+
+uint32_t LatencyStats::percentile(uint8_t percent) const {
+  // Counted from the buckets, so saturated buckets make it approximate;
+  // a bucket's upper bound is capped by the largest latency seen
+  uint32_t total = 0;
+  for (int i = 0; i < BUCKETS; i++) {
+    total += buckets[i];
+  }
+  if (total == 0) {
+    return 0;
+  }
+  uint32_t target = (total * percent + 99) / 100;
+  uint32_t seen = 0;
+  for (int i = 0; i < BUCKETS - 1; i++) {
+    seen += buckets[i];
+    if (seen >= target) {
+      uint32_t bound = (i + 1) * BUCKET_US;
+      return (bound < max) ? bound : max;
+    }
+  }
+  return max;
+}
+
+void BusStats::reset() {
+  memset(this, 0, sizeof(*this));
+}
+
+void BusStats::add(uint8_t tileWidth, uint8_t tileHeight) {
+  // A tile is 8 bytes; u8g2 sends each tile row as one transfer
+  uint32_t size = (uint32_t)tileWidth * tileHeight * 8;
+  flushes++;
+  bytes += size;
+  transactions += tileHeight;
+  windowBytes += size;
+  windowTransactions += tileHeight;
+}
+
+void BusStats::closeWindow(unsigned long elapsed) {
+  bytesPerSecond = (uint64_t)windowBytes * 1000 / elapsed;
+  transactionsPerSecond = (uint64_t)windowTransactions * 1000 / elapsed;
+  windowBytes = 0;
+  windowTransactions = 0;
+}
+
+const StageStats& OLEDKeyboard::getStageStats(ProfileStage stage) const {
+  return _stageStats[stage];
+}
+
+const LatencyStats& OLEDKeyboard::getLatencyStats() const {
+  return _latencyStats;
+}
+
+const BusStats& OLEDKeyboard::getBusStats(FlushKind kind) const {
+  return _busStats[kind];
+}
+
+void OLEDKeyboard::resetStageStats() {
+  for (int i = 0; i < STAGE_COUNT; i++) {
+    _stageStats[i].reset();
+  }
+  _latencyStats.reset();
+  for (int i = 0; i < FLUSH_KIND_COUNT; i++) {
+    _busStats[i].reset();
+  }
+  _busWindowStart = _clock();        // Rates only cover bytes counted since
+}
+
+void OLEDKeyboard::frameSent() {
+  _busStats[FLUSH_FULL].add(_display->getBufferTileWidth(), _display->getBufferTileHeight());
+  if (_latencyPending) {
+    _latencyStats.add(profileMicros(profileTicks() - _latencyStart));
+    _latencyPending = false;
+  }
+}
+
+void OLEDKeyboard::printStageStats(Print& out) const {
+  static const char* const names[STAGE_COUNT] = { "input", "text", "keys", "flush" };
+  
+  // One line per stage: count, min/avg/max and the non-empty histogram
+  // bins as <upper bound in us>:<count>
+  for (int i = 0; i < STAGE_COUNT; i++) {
+    const StageStats& stats = _stageStats[i];
+    out.print(names[i]);
+    out.print(F(" n="));
+    out.print(stats.count);
+    if (stats.count > 0) {
+      out.print(F(" min/avg/max="));
+      out.print(stats.min);
+      out.print('/');
+      out.print(stats.average());
+      out.print('/');
+      out.print(stats.max);
+      out.print(F("us"));
+      for (int bin = 0; bin < StageStats::BINS; bin++) {
+        if (stats.histogram[bin] > 0) {
+          out.print(' ');
+          if (bin == StageStats::BINS - 1) {
+            out.print('>');
+          } else {
+            out.print('<');
+            out.print(1UL << (bin + 1));
+          }
+          out.print(':');
+          out.print(stats.histogram[bin]);
+        }
+      }
+    }
+    out.println();
+  }
+  
+  out.print(F("latency n="));
+  out.print(_latencyStats.count);
+  if (_latencyStats.count > 0) {
+    out.print(F(" p50/p95/p99/max="));
+    out.print(_latencyStats.p50());
+    out.print('/');
+    out.print(_latencyStats.p95());
+    out.print('/');
+    out.print(_latencyStats.p99());
+    out.print('/');
+    out.print(_latencyStats.max);
+    out.print(F("us"));
+  }
+  out.println();
+  
+  // Bus traffic: totals, then rates over the last window
+  static const char* const kinds[FLUSH_KIND_COUNT] = { "full", "partial" };
+  for (int i = 0; i < FLUSH_KIND_COUNT; i++) {
+    const BusStats& bus = _busStats[i];
+    out.print(kinds[i]);
+    out.print(F(" n="));
+    out.print(bus.flushes);
+    out.print(F(" bytes="));
+    out.print(bus.bytes);
+    out.print(F(" tx="));
+    out.print(bus.transactions);
+    out.print(F(" B/s="));
+    out.print(bus.bytesPerSecond);
+    out.print(F(" tx/s="));
+    out.println(bus.transactionsPerSecond);
+  }
+}
+
+void OLEDKeyboard::setStatsInterval(unsigned long interval, Print& out) {
+  _statsInterval = interval;
+  _statsOutput = &out;
+  _lastStatsDump = _clock();
+}
+#endif
+
+void OLEDKeyboard::setClock(ClockFunction clock) {
+  _clock = (clock != NULL) ? clock : millis;
+  _input->setClock(_clock);
+  _lastCursorBlink = _clock();
+  _lastActivity = _clock();
+#if OLEDKEYBOARD_PROFILE
+  _busWindowStart = _clock();
+#endif
 }
 
 void OLEDKeyboard::setCursorBlinkInterval(unsigned long interval) {
-  _cursorBlinkInterval = interval;
+  // Half the 16-bit stamp range, so a blink is at most one interval late
+  // even when poll() was not called for longer than the stamp wraps
+  _cursorBlinkInterval = (interval < 0x7FFF) ? interval : 0x7FFF;
+}
+
+void OLEDKeyboard::setMasked(bool masked) {
+  _masked = masked;
+  _measureText();
+  _needsRedraw = true;
+}
+
+void OLEDKeyboard::setRevealTime(unsigned long time) {
+  // Half the 16-bit stamp range, as for the blink
+  _revealTime = (time < 0x7FFF) ? time : 0x7FFF;
+}
+
+void OLEDKeyboard::setIdleTimeout(unsigned long timeout) {
+  _idleTimeout = timeout;
+  _lastActivity = _clock();
+}
+
+void OLEDKeyboard::setInputProfile(InputProfile profile) {
+  _inputProfile = profile;
+  
+  // Remember which layers hold usable keys ('.' sits on every layer,
+  // so only letters and digits make a layer worth visiting)
+  _allowedLayers = 0;
+  for (int state = STATE_UPPERCASE; state <= STATE_FREQUENT; state++) {
+    const char* const* keys = _getKeys((KeyboardState)state);
+    for (int i = 0; keys != NULL && i < KEY_COUNT; i++) {
+      if (!_isSpecialKey(keys[i]) && isalnum((uint8_t)keys[i][0]) && _isCharAllowed(keys[i][0])) {
+        _allowedLayers |= (1 << state);
+        break;
+      }
+    }
+  }
+  
+  _currentState = _profileLayer();
+  _selectedKeyIndex = 0;
+  _moveSelection(0);
+  _needsRedraw = true;
+}
+
+InputProfile OLEDKeyboard::getInputProfile() const {
+  return _inputProfile;
+}
+
+void OLEDKeyboard::setDictionary(const uint8_t* dictionary) {
+  _dictionary = dictionary;
+  _resyncDictionary();
+  _moveSelection(0);
+  _needsRedraw = true;
+}
+
+int OLEDKeyboard::getCompletionCount() const {
+  // Nothing is offered for an empty word, a prefix that is not in the
+  // trie or with the cursor inside the text
+  if (_dictionary == NULL || _dictNode == NO_NODE || _dictDepth == 0 ||
+      _gapEnd != OLEDKEYBOARD_MAX_LENGTH) {
+    return 0;
+  }
+  int count = dictByte(_dictionary, _dictNode + 1);
+  return (count < MAX_COMPLETIONS) ? count : MAX_COMPLETIONS;
+}
+
+String OLEDKeyboard::getCompletion(int index) const {
+  String completion = "";
+  if (index < 0 || index >= getCompletionCount()) {
+    return completion;
+  }
+  
+  uint16_t word = dictOffset(_dictionary, _dictNode + 2 + 2 * index);
+  for (char c = dictByte(_dictionary, word); c != '\0'; c = dictByte(_dictionary, ++word)) {
+    completion += c;
+  }
+  return completion;
+}
+
+void OLEDKeyboard::setKeyPrediction(KeyPrediction mode) {
+  _keyPrediction = mode;
+}
+
+KeyPrediction OLEDKeyboard::getKeyPrediction() const {
+  return _keyPrediction;
+}
+
+void OLEDKeyboard::setFrequentLayer(bool enabled) {
+  KeyboardState home = _profileLayer();
+  _frequentLayer = enabled;
+  _buildFrequentLayer();
+  
+  // Follow the change of home layer unless another layer was chosen
+  if (_currentState == home || _currentState == STATE_FREQUENT) {
+    _currentState = _profileLayer();
+  }
+  _moveSelection(0);
+}
+
+size_t OLEDKeyboard::saveUsage(uint8_t* buffer, size_t size) const {
+  static_assert(USAGE_DATA_SIZE == 1 + 2 * BIGRAM_SLOTS, "usage data layout");
+  if (size < USAGE_DATA_SIZE) {
+    return 0;
+  }
+  
+  // Version byte, key usage counts, learned bigrams
+  buffer[0] = 1;
+  memcpy(buffer + 1, _keyUsage, BIGRAM_SLOTS);
+  memcpy(buffer + 1 + BIGRAM_SLOTS, _learnedNext, BIGRAM_SLOTS);
+  return USAGE_DATA_SIZE;
+}
+
+bool OLEDKeyboard::loadUsage(const uint8_t* buffer, size_t size) {
+  if (size < USAGE_DATA_SIZE || buffer[0] != 1) {
+    return false;
+  }
+  
+  memcpy(_keyUsage, buffer + 1, BIGRAM_SLOTS);
+  memcpy(_learnedNext, buffer + 1 + BIGRAM_SLOTS, BIGRAM_SLOTS);
+  _buildFrequentLayer();
+  return true;
+}
+
+void OLEDKeyboard::clearHistory() {
+  memset(_history, 0xFF, sizeof(_history));
+  _moveSelection(0);
+}
+
+size_t OLEDKeyboard::saveHistory(uint8_t* buffer, size_t size) const {
+  if (size < HISTORY_DATA_SIZE) {
+    return 0;
+  }
+  
+  // Version byte, then the entries as stored
+  buffer[0] = 1;
+  memcpy(buffer + 1, _history, OLEDKEYBOARD_HISTORY_SIZE);
+  return HISTORY_DATA_SIZE;
+}
+
+bool OLEDKeyboard::loadHistory(const uint8_t* buffer, size_t size) {
+  if (size < HISTORY_DATA_SIZE || buffer[0] != 1) {
+    return false;
+  }
+  
+  memcpy(_history, buffer + 1, OLEDKEYBOARD_HISTORY_SIZE);
+  _trimHistory();
+  _moveSelection(0);
+  return true;
+}
+
+void OLEDKeyboard::setFont(const uint8_t* font) {
+  setInputFont(font);
+  setKeyFont(font);
+}
+
+void OLEDKeyboard::setKeyFont(const uint8_t* font) {
+  _keyFont = font;
+  const uint8_t* previous = _useFont(font);
+  _keyAscent = _display->getAscent();
+  _useFont(previous);
+  _labelKeys = NULL;
+  _needsRedraw = true;
+}
+
+void OLEDKeyboard::setInputFont(const uint8_t* font) {
+  _inputFont = font;
+  const uint8_t* previous = _useFont(font);
+  
+  // Cache the ASCII advances once instead of measuring strings per frame
+  for (int c = 32; c < 127; c++) {
+    _advance[c - 32] = u8g2_GetGlyphWidth(_display->getU8g2(), c);
+  }
+  _inputAscent = _display->getAscent();
+  _useFont(previous);
+  _measureText();
+  _needsRedraw = true;
+}
+
+void OLEDKeyboard::setLayout(KeyboardState state, const char* const* keys) {
+#if OLEDKEYBOARD_SYMBOLS
+  const char* const* defaults[3] = { _keysUpper, _keysLower, _keysSymbols };
+#else
+  const char* const* defaults[3] = { _keysUpper, _keysLower, NULL };
+#endif
+  if (state > STATE_SYMBOLS) {
+    return;
+  }
+  _layouts[state] = (keys != NULL) ? keys : defaults[state];
+  _labelKeys = NULL;
+  setInputProfile(_inputProfile);
 }
 
 void OLEDKeyboard::setInputAreaHeight(int height) {
-  if (height > 0) {
+  if (height > 0 && height <= 0xFF) {
     _inputAreaHeight = height;
     _calculateLayout();
   }
 }
 
 void OLEDKeyboard::setKeySize(int width, int height) {
-  if (width > 0 && height > 0) {
+  if (width > 0 && height > 0 && width <= 0xFF && height <= 0xFF) {
     _keyWidth = width;
     _keyHeight = height;
+    _labelKeys = NULL;
     _calculateLayout();
   }
 }
 
 void OLEDKeyboard::setKeySpacing(int horizontal, int vertical) {
-  if (horizontal >= 0 && vertical >= 0) {
+  if (horizontal >= 0 && vertical >= 0 && horizontal <= 0xFF && vertical <= 0xFF) {
     _hSpacing = horizontal;
     _vSpacing = vertical;
     _calculateLayout();
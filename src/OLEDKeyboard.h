@@ -14,18 +14,141 @@
 
 #include <Arduino.h>
 #include <U8g2lib.h>
+#include "OLEDInput.h"
+#include "OLEDRecorder.h"
+
+// Capacity of the input buffer in bytes (UTF-8 characters take 1-4)
+#ifndef OLEDKEYBOARD_MAX_LENGTH
+#define OLEDKEYBOARD_MAX_LENGTH 64
+#endif
+#if OLEDKEYBOARD_MAX_LENGTH > 255
+#error "OLEDKEYBOARD_MAX_LENGTH must not exceed 255"
+#endif
+
+// Number of single-character edits that can be undone
+#ifndef OLEDKEYBOARD_UNDO_DEPTH
+#define OLEDKEYBOARD_UNDO_DEPTH 16
+#endif
+
+// Bytes reserved for recently submitted strings (see saveHistory)
+#ifndef OLEDKEYBOARD_HISTORY_SIZE
+#define OLEDKEYBOARD_HISTORY_SIZE 96
+#endif
+
+// Optional features; set to 0 to leave them out of tight builds
+#ifndef OLEDKEYBOARD_SYMBOLS
+#define OLEDKEYBOARD_SYMBOLS 1       // Built-in symbols layer
+#endif
+#ifndef OLEDKEYBOARD_CURSOR_BLINK
+#define OLEDKEYBOARD_CURSOR_BLINK 1  // Blinking text cursor (else steady)
+#endif
+#ifndef OLEDKEYBOARD_SCROLLING
+#define OLEDKEYBOARD_SCROLLING 1     // Scrolling long text (else clipped)
+#endif
+
+// Set to 1 to time the update stages (see getStageStats)
+#ifndef OLEDKEYBOARD_PROFILE
+#define OLEDKEYBOARD_PROFILE 0
+#endif
 
 // Keyboard states
 enum KeyboardState {
   STATE_UPPERCASE,
   STATE_LOWERCASE,
-  STATE_SYMBOLS
+  STATE_SYMBOLS,
+  STATE_FREQUENT                     // Most used keys first (see setFrequentLayer)
+};
+
+// Input profiles (restrict keys and validate while typing)
+enum InputProfile {
+  PROFILE_TEXT,
+  PROFILE_NUMERIC,
+  PROFILE_HEX,
+  PROFILE_IPV4,
+  PROFILE_HOSTNAME
+};
+
+// Next-key prediction (selection jumps to the likely next key)
+enum KeyPrediction {
+  PREDICT_OFF,
+  PREDICT_STATIC,                    // Built-in English letter bigrams
+  PREDICT_LEARNED                    // Learn bigrams from typed text
+};
+
+#if OLEDKEYBOARD_PROFILE
+// Timed stages of an update
+enum ProfileStage {
+  STAGE_INPUT,                       // handleInput()
+  STAGE_INPUT_AREA,                  // Drawing the text line
+  STAGE_KEYBOARD,                    // Drawing the keys
+  STAGE_FLUSH,                       // Sending the buffer (full or partial)
+  STAGE_COUNT
+};
+
+// Timings of one stage in microseconds
+struct StageStats {
+  static const int BINS = 16;
+  uint32_t count;
+  uint32_t min;
+  uint32_t max;
+  uint64_t total;
+  uint16_t histogram[BINS];          // [i]: 2^i to 2^(i+1) - 1 us ([0] from 0, last open)
+  
+  void reset();
+  void add(uint32_t us);
+  uint32_t average() const;
+};
+
+// Button-to-display latency: from an input edge to the end of the first
+// flush showing its effect
+struct LatencyStats {
+  static const int BUCKETS = 64;
+  static const uint32_t BUCKET_US = 2000; // Last bucket from 126 ms up
+  uint32_t count;
+  uint32_t max;
+  uint16_t buckets[BUCKETS];
+  
+  void reset();
+  void add(uint32_t us);
+  uint32_t percentile(uint8_t percent) const; // Bucket upper bound in us, at most max
+  uint32_t p50() const { return percentile(50); }
+  uint32_t p95() const { return percentile(95); }
+  uint32_t p99() const { return percentile(99); }
+};
+
+// Display flushes counted by the bus stats
+enum FlushKind {
+  FLUSH_FULL,                        // Whole buffer (draw(), frameSent())
+  FLUSH_PARTIAL,                     // Tiles patched by update()
+  FLUSH_KIND_COUNT
+};
+
+// Display traffic of one kind of flush: tile data bytes and transfers
+// (one per tile row), without command and addressing overhead
+struct BusStats {
+  uint32_t flushes;
+  uint32_t bytes;
+  uint32_t transactions;
+  uint32_t bytesPerSecond;           // Rates over the last window of at least 1 s
+  uint32_t transactionsPerSecond;
+  uint32_t windowBytes;              // Counted since the window started
+  uint32_t windowTransactions;
+  
+  void reset();
+  void add(uint8_t tileWidth, uint8_t tileHeight);
+  void closeWindow(unsigned long elapsed);
 };
+#endif
 
 class OLEDKeyboard {
   public:
-    // Constructor
+    static const size_t USAGE_DATA_SIZE = 1 + 2 * (26 + 32); // saveUsage() bytes
+    static const size_t HISTORY_DATA_SIZE = 1 + OLEDKEYBOARD_HISTORY_SIZE; // saveHistory() bytes
+    static const unsigned long NO_DEADLINE = 0xFFFFFFFFUL; // nextDeadlineMs() while idle
+    
+    // Constructors
     OLEDKeyboard(U8G2* display, int upPin, int downPin, int selectPin);
+    OLEDKeyboard(U8G2* display, InputSource* input); // Encoder, ladder, ... (see OLEDInput.h)
     
     // Main functions
     void begin();
@@ -33,69 +156,291 @@ class OLEDKeyboard {
     void handleInput();              // Process button inputs
     void draw();                     // Draw keyboard interface
     
+    // Shared display (see OLEDCompositor)
+    bool poll();                     // update() without drawing
+    void render();                   // Draw into the region, no clear or flush
+    void setRegion(int x, int y, int width, int height); // Area used by the keyboard
+    
+    // Sleeping between updates
+    unsigned long nextDeadlineMs() const; // Time until update() is next needed
+    bool attachInterrupts();         // Button presses end the wait (one keyboard only)
+    void detachInterrupts();
+    
     // Input management
     bool isInputComplete() const;    // Check if input is finished
+    bool isIdle() const;             // Idle timeout reached, panel powered down
     String getInputText() const;     // Get entered text
+    size_t getInputText(char* buffer, size_t size) const; // Copy without heap use
     void clearInput();               // Clear current input
     void reset();                    // Reset to initial state
+    bool undo();                     // Undo the last edit, false if none
+    bool redo();                     // Redo the last undone edit
+    bool isInputValid() const;       // Check input against the active profile
     
     // Configuration
-    void setMaxLength(int maxLen);   // Set maximum input length
+    void setMaxLength(int maxLen);   // Set maximum input length in characters
     void setPosition(int x, int y);  // Set keyboard position
-    void setDebounceDelay(unsigned long delay); // Set button debounce delay
+    void setDebounceDelay(unsigned long delay); // Set button debounce delay (built-in buttons)
+    void setInput(InputSource* input); // Before begin(), NULL = built-in buttons
+    void setClock(ClockFunction clock); // Time source for keyboard and input, NULL = millis()
+    void setObserver(InputObserver* observer); // Recorder or replay check, NULL = none
+    
+#if OLEDKEYBOARD_PROFILE
+    // Stage timing
+    const StageStats& getStageStats(ProfileStage stage) const;
+    const LatencyStats& getLatencyStats() const;
+    const BusStats& getBusStats(FlushKind kind) const;
+    void resetStageStats();          // Also clears the latency and bus stats
+    void frameSent();                // After flushing a frame with render() output
+    void printStageStats(Print& out) const;
+    void setStatsInterval(unsigned long interval, Print& out = Serial); // Periodic dump from update(), 0 = off
+#endif
     void setCursorBlinkInterval(unsigned long interval); // Set cursor blink speed
+    void setMasked(bool masked);     // Show '*' instead of the text (passwords)
+    void setRevealTime(unsigned long time); // Masked: show the last character this long
+    void setIdleTimeout(unsigned long timeout); // Power down after this long without input, 0 = never
+    void setInputProfile(InputProfile profile); // Restrict keys to a profile
+    InputProfile getInputProfile() const;
+    
+    // Word completion
+    void setDictionary(const uint8_t* dictionary); // PROGMEM trie from extras/make_dictionary.py
+    int getCompletionCount() const;  // Completions offered for the current word
+    String getCompletion(int index) const;
+    
+    // Next-key prediction
+    void setKeyPrediction(KeyPrediction mode);
+    KeyPrediction getKeyPrediction() const;
+    
+    // Usage-ordered layer
+    void setFrequentLayer(bool enabled); // Home layer ordered by key usage
+    size_t saveUsage(uint8_t* buffer, size_t size) const; // For EEPROM/flash
+    bool loadUsage(const uint8_t* buffer, size_t size);
+    
+    // Input history
+    void clearHistory();
+    size_t saveHistory(uint8_t* buffer, size_t size) const; // For EEPROM/flash
+    bool loadHistory(const uint8_t* buffer, size_t size);
     
     // Display settings
     void setInputAreaHeight(int height);
     void setKeySize(int width, int height);
     void setKeySpacing(int horizontal, int vertical);
+    void setFont(const uint8_t* font); // U8g2 font for keys and input
+    void setKeyFont(const uint8_t* font);
+    void setInputFont(const uint8_t* font);
+    void setLayout(KeyboardState state, const char* const* keys); // 32 UTF-8 labels, NULL = default
     
   private:
-    // Display and pins
+    // Display and input
     U8G2* _display;
-    int _upPin, _downPin, _selectPin;
+    ButtonInput _buttons;            // Pins given to the constructor
+    InputSource* _input;
+    InputObserver* _observer;
     
     // Keyboard layout constants
     static const int KEY_ROWS = 4;
     static const int KEY_COLS = 8;
     static const int KEY_COUNT = KEY_ROWS * KEY_COLS;
+    static const int MAX_COMPLETIONS = 3;
+    static const int MAX_HISTORY_SLOTS = 5;
+    static const uint16_t NO_NODE = 0xFFFF;
+    static const int BIGRAM_SLOTS = 26 + KEY_COUNT; // Letters + symbol keys
+    
+    // Modes entered from the edit entries next to the keys
+    enum EditMode {
+      EDIT_NONE,
+      EDIT_CURSOR,                   // UP/DOWN move the text cursor
+      EDIT_UNDO                      // UP undoes, DOWN redoes
+    };
+    
+    // Undo journal record flags
+    static const uint8_t JOURNAL_DELETE = 0x00;
+    static const uint8_t JOURNAL_INSERT = 0x01;
+    static const uint8_t JOURNAL_CHAINED = 0x02; // Undone with the previous one
+    static const uint8_t JOURNAL_BULK = 0x04; // Insert of c bytes, cannot be redone
     
     // Display dimensions and layout
-    int _screenWidth, _screenHeight;
-    int _inputAreaHeight;
-    int _keyWidth, _keyHeight;
-    int _hSpacing, _vSpacing;
-    int _keyboardX, _keyboardY;
-    int _maxInputLength;
-    
-    // State variables
-    KeyboardState _currentState;
-    String _inputText;
-    bool _inputComplete;
-    bool _cursorVisible;
-    int _selectedKeyIndex;
-    
-    // Timing variables
-    unsigned long _lastCursorBlink;
-    unsigned long _lastUpPress;
-    unsigned long _lastDownPress;
-    unsigned long _lastSelectPress;
-    unsigned long _debounceDelay;
-    unsigned long _cursorBlinkInterval;
+    int16_t _screenWidth, _screenHeight;
+    int16_t _regionX, _regionY;
+    int16_t _regionWidth, _regionHeight; // 0 = whole display
+    int16_t _keyboardX, _keyboardY;
+    uint8_t _inputAreaHeight;
+    uint8_t _keyWidth, _keyHeight;
+    uint8_t _hSpacing, _vSpacing;
+    uint8_t _maxInputLength;
+    
+    // State variables, flags packed into bits
+    KeyboardState _currentState : 2;
+    InputProfile _inputProfile : 3;
+    KeyPrediction _keyPrediction : 2;
+    uint8_t _editMode : 2;           // EditMode
+    uint8_t _allowedLayers : 4;      // Bit per KeyboardState with usable keys
+    bool _inputComplete : 1;
+    bool _cursorVisible : 1;
+    bool _needsRedraw : 1;           // update() skips drawing unchanged frames
+    bool _idle : 1;                  // Not drawing, panel in power save
+    bool _masked : 1;
+    bool _revealing : 1;             // Character before the cursor shown unmasked
+    bool _journalChain : 1;          // Chain undo records to the previous one
+    bool _journalBulk : 1;           // Inserting a bulk record's bytes
+    bool _frequentLayer : 1;         // Usage-ordered layer enabled
+    volatile bool _inputPending;     // Button interrupt since the last poll() (a byte, set by the ISR)
+    int8_t _selectedKeyIndex;        // >= KEY_COUNT selects a suggestion or edit
+    uint8_t _revealWidth;
+    int16_t _revealX;                // Drawn revealed cell, -1 if none
+    int16_t _textX;                  // Where the visible text was drawn
+    int16_t _cursorX;                // Drawn blinking cursor, -1 if none
+    
+    // Input text as a gap buffer: [0, _gapStart) before the cursor,
+    // [_gapEnd, OLEDKEYBOARD_MAX_LENGTH) after it
+    char _text[OLEDKEYBOARD_MAX_LENGTH];
+    uint8_t _gapStart;
+    uint8_t _gapEnd;
+    uint8_t _charCount;              // UTF-8 characters in the buffer
+    
+    // Pixel widths kept up to date by each edit, so drawing never has
+    // to measure the whole text
+    uint16_t _textWidth;
+    uint16_t _cursorOffset;          // Width of the text before the cursor
+    uint8_t _scrollStart;            // First visible byte (character boundary)
+    uint16_t _scrollOffset;          // Width of the text before _scrollStart
+    
+    // Fonts and their cached metrics (the display font is restored after
+    // drawing, so the keyboard can share the display)
+    const uint8_t* _inputFont;
+    const uint8_t* _keyFont;
+    int8_t _advance[95];             // Input font advance of ASCII 32-126
+    int8_t _inputAscent;
+    int8_t _keyAscent;
+    int8_t _labelX[KEY_COUNT];       // Centred label offsets for _labelKeys
+    const char* const* _labelKeys;   // Layer the offsets belong to, NULL = stale
+    
+    // Undo journal: ring of single-character edits, redo entries follow
+    // the undo entries and are dropped by any new edit
+    struct JournalEntry {
+      uint8_t position;
+      char c;
+      uint8_t flags;
+    };
+    JournalEntry _journal[OLEDKEYBOARD_UNDO_DEPTH];
+    uint8_t _journalHead;            // Slot of the next record
+    uint8_t _undoCount;
+    uint8_t _redoCount;
+    
+    // Word completion
+    const uint8_t* _dictionary;
+    uint16_t _dictNode;              // Trie node of the current word
+    uint8_t _dictDepth;              // Characters typed in the current word
+    
+    // Next-key prediction
+    uint8_t _learnedNext[BIGRAM_SLOTS]; // Next char, high bit = confirmed
+    
+    // Usage-ordered layer
+    uint8_t _keyUsage[BIGRAM_SLOTS];
+    const char* _keysFrequent[KEY_COUNT];
+    
+    // Input history, newest first: [profile][text]['\0']..., 0xFF when unused
+    uint8_t _history[OLEDKEYBOARD_HISTORY_SIZE];
+    
+    // Timing variables; the blink and the reveal only need the low 16
+    // bits of the clock
+    ClockFunction _clock;
+    unsigned long _lastActivity;
+    unsigned long _idleTimeout;
+    uint16_t _lastCursorBlink;
+    uint16_t _cursorBlinkInterval;   // At most 32767 ms
+    uint16_t _revealStart;           // Set by each typed masked character
+    uint16_t _revealTime;            // At most 32767 ms
+    
+#if OLEDKEYBOARD_PROFILE
+    StageStats _stageStats[STAGE_COUNT];
+    LatencyStats _latencyStats;
+    volatile uint32_t _edgeTicks;    // First input edge seen by the interrupt
+    volatile bool _edgeStamped;
+    uint32_t _latencyStart;          // Edge of the input not shown yet
+    bool _latencyPending;
+    Print* _statsOutput;
+    unsigned long _statsInterval;
+    unsigned long _lastStatsDump;
+    BusStats _busStats[FLUSH_KIND_COUNT];
+    unsigned long _busWindowStart;
+#endif
     
     // Keyboard layouts
     static const char* const _keysUpper[KEY_COUNT];
     static const char* const _keysLower[KEY_COUNT];
+#if OLEDKEYBOARD_SYMBOLS
     static const char* const _keysSymbols[KEY_COUNT];
+#endif
+    static const char _nextLetter[26];
+    static const char _letterPriority[26];
+    const char* const* _layouts[3];  // Upper, lower, symbols (custom or built-in)
+    
+    static OLEDKeyboard* _interruptTarget;
+    static void _onButtonInterrupt();
     
     // Private methods
     void _calculateLayout();
+    void _clipToRegion();
+    void _concealRevealed();
+#if OLEDKEYBOARD_CURSOR_BLINK
+    void _blinkCursor();
+#endif
+    void _sendTiles(int tileX, int tileY, int tileWidth, int tileHeight); // Partial flush
+    void _wake();
+    void _handleEvent(InputEvent event);
     void _drawInputArea();
+    void _drawVisibleText(int x, int baseline);
+    void _drawCursor(int x, int baseline);
     void _drawKeyboard();
     const char* const* _getCurrentKeys() const;
+    const char* const* _getKeys(KeyboardState state) const;
     void _processKeyPress(const char* key);
     bool _isSpecialKey(const char* key) const;
     void _handleSpecialKey(const char* key);
+    void _moveSelection(int step);
+    int _extraCount() const;
+    void _selectExtra(int index);
+    uint8_t _extraMode(int index) const;
+    bool _enterChar(const char* c);  // Validated insert of one UTF-8 character
+    bool _eraseChar();               // Delete the character before the cursor
+    int _textLength() const;         // In bytes
+    char _charAt(int index) const;
+    bool _insertChar(char c);
+    bool _deleteChar();
+    void _moveCursor(int step);      // By characters
+    void _moveGap(int position);     // By bytes, widths are not updated
+    int _glyphWidth(int index) const;
+    int _stringWidth(const char* text) const;
+    const uint8_t* _useFont(const uint8_t* font) const; // Returns the previous font
+    void _measureText();
+    void _recordEdit(uint8_t kind, int position, char c); // JOURNAL_INSERT, _DELETE or _BULK
+    int _beginBulkInsert();          // Returns the position for _endBulkInsert()
+    void _endBulkInsert(int position);
+    void _clearText();
+    void _advanceDictionary(char c);
+    void _resyncDictionary();
+    void _acceptCompletion(int index);
+    int _suggestionCount() const;
+    void _suggestionSuffix(int index, char* buffer, size_t size) const;
+    void _acceptSuggestion(int index);
+    int _historyEntry(int index) const;
+    int _nextHistoryEntry(int offset) const;
+    void _addHistory();
+    void _trimHistory();
+    int _bigramIndex(char c) const;
+    char _predictNextChar(char c) const;
+    void _learnBigram(char previous, char next);
+    void _selectPredictedKey(char c);
+    int _keySlot(const char* key) const;
+    const char* _slotLabel(int slot) const;
+    void _recordUsage(const char* key);
+    void _buildFrequentLayer();
+    bool _isKeyAllowed(const char* key) const;
+    bool _isCharAllowed(char c) const;
+    bool _acceptsChar(char c) const;
+    KeyboardState _profileLayer() const;
+    KeyboardState _layerAfter(const char* key) const;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,151 @@
+/*
+  OLEDRecorder.cpp - Input recording and replay for OLEDKeyboard
+  
+  Created by Sk Raihan, SKR Electronics Lab
+  https://github.com/skr-electronics-lab
+*/
+
+#include "OLEDRecorder.h"
+
+static const uint8_t LOG_VERSION = 1;
+
+// Delay of a record in ms; built unsigned, as an int is 16 bits on AVR
+static inline uint16_t recordDelay(const uint8_t* record) {
+  return (uint16_t)(record[0] | ((uint16_t)record[1] << 8));
+}
+
+// InputRecorder
+
+InputRecorder::InputRecorder(uint8_t* buffer, size_t size)
+  : _buffer(buffer), _capacity(size) {
+  clear();
+}
+
+void InputRecorder::onEvent(unsigned long time, InputEvent event, uint8_t layer, uint8_t selection, uint8_t length) {
+  if (_full) {
+    return;
+  }
+  
+  unsigned long delta = (_size > HEADER_SIZE) ? time - _lastTime : 0;
+  while (delta > 0xFFFF) {
+    if (!_write(0xFFFF, EVENT_NONE, 0, 0)) {
+      return;
+    }
+    delta -= 0xFFFF;
+  }
+  if (_write(delta, event | (layer << 3), selection, length)) {
+    _lastTime = time;
+  }
+}
+
+void InputRecorder::clear() {
+  _size = 0;
+  _full = (_capacity < HEADER_SIZE);
+  _lastTime = 0;
+  if (!_full) {
+    _buffer[_size++] = 'O';
+    _buffer[_size++] = 'K';
+    _buffer[_size++] = LOG_VERSION;
+  }
+}
+
+const uint8_t* InputRecorder::data() const {
+  return _buffer;
+}
+
+size_t InputRecorder::size() const {
+  return _size;
+}
+
+bool InputRecorder::isFull() const {
+  return _full;
+}
+
+bool InputRecorder::_write(uint16_t delta, uint8_t event, uint8_t selection, uint8_t length) {
+  if (_size + RECORD_SIZE > _capacity) {
+    _full = true;
+    return false;
+  }
+  _buffer[_size++] = delta & 0xFF;
+  _buffer[_size++] = delta >> 8;
+  _buffer[_size++] = event;
+  _buffer[_size++] = selection;
+  _buffer[_size++] = length;
+  return true;
+}
+
+// InputReplay
+
+InputReplay::InputReplay(const uint8_t* data, size_t size)
+  : _data(data), _size(size) {
+  // A log with a foreign header replays nothing
+  bool valid = (size >= InputRecorder::HEADER_SIZE && data[0] == 'O' && data[1] == 'K' && data[2] == LOG_VERSION);
+  _size = valid ? size : 0;
+  _next = InputRecorder::HEADER_SIZE;
+  _expected = NULL;
+  _start = 0;
+  _due = 0;
+  _events = 0;
+  _mismatches = 0;
+}
+
+void InputReplay::begin() {
+  _next = InputRecorder::HEADER_SIZE;
+  _expected = NULL;
+  _start = _now();
+  _due = 0;
+  _events = 0;
+  _mismatches = 0;
+}
+
+InputEvent InputReplay::read() {
+  while (!isFinished()) {
+    const uint8_t* record = _data + _next;
+    unsigned long due = _due + recordDelay(record);
+    if (_now() - _start < due) {
+      return EVENT_NONE;
+    }
+    _due = due;
+    _next += InputRecorder::RECORD_SIZE;
+    
+    InputEvent event = (InputEvent)(record[2] & 0x07);
+    if (event != EVENT_NONE) {
+      _expected = record;
+      _events++;
+      return event;
+    }
+  }
+  return EVENT_NONE;
+}
+
+unsigned long InputReplay::nextDeadlineMs() const {
+  if (isFinished()) {
+    return NO_DEADLINE;
+  }
+  const uint8_t* record = _data + _next;
+  unsigned long due = _due + recordDelay(record);
+  unsigned long elapsed = _now() - _start;
+  return (elapsed >= due) ? 0 : due - elapsed;
+}
+
+void InputReplay::onEvent(unsigned long, InputEvent event, uint8_t layer, uint8_t selection, uint8_t length) {
+  if (_expected == NULL) {
+    return;
+  }
+  if (_expected[2] != (event | (layer << 3)) || _expected[3] != selection || _expected[4] != length) {
+    _mismatches++;
+  }
+  _expected = NULL;
+}
+
+bool InputReplay::isFinished() const {
+  return _next + InputRecorder::RECORD_SIZE > _size;
+}
+
+unsigned long InputReplay::getEventCount() const {
+  return _events;
+}
+
+unsigned long InputReplay::getMismatches() const {
+  return _mismatches;
+}
@@ -0,0 +1,80 @@
+/*
+  OLEDRecorder.h - Input recording and replay for OLEDKeyboard
+  
+  Created by Sk Raihan, SKR Electronics Lab
+  https://github.com/skr-electronics-lab
+  
+  InputRecorder keeps a compact binary log of the events the keyboard
+  handled and the state each one left behind. InputReplay feeds such a
+  log back into a keyboard at the recorded times and counts where the
+  state differs, e.g. headless on U8G2_NULL with a VirtualClock.
+  
+  Log format: 'O' 'K' version, then 5-byte records
+    [ms since the previous record, 2 bytes LE]
+    [event | layer << 3] [selection] [text length in characters]
+  Longer pauses are split with EVENT_NONE records of 65535 ms.
+*/
+
+#ifndef OLEDRECORDER_H
+#define OLEDRECORDER_H
+
+#include <Arduino.h>
+#include "OLEDInput.h"
+
+// Told about every event the keyboard handled (see setObserver)
+class InputObserver {
+  public:
+    virtual ~InputObserver() {}
+    virtual void onEvent(unsigned long time, InputEvent event, uint8_t layer, uint8_t selection, uint8_t length) = 0;
+};
+
+class InputRecorder : public InputObserver {
+  public:
+    static const size_t HEADER_SIZE = 3;
+    static const size_t RECORD_SIZE = 5;
+    
+    InputRecorder(uint8_t* buffer, size_t size);
+    
+    void onEvent(unsigned long time, InputEvent event, uint8_t layer, uint8_t selection, uint8_t length);
+    void clear();
+    const uint8_t* data() const;
+    size_t size() const;             // Bytes recorded, including the header
+    bool isFull() const;             // Later events are dropped
+    
+  private:
+    uint8_t* _buffer;
+    size_t _capacity;
+    size_t _size;
+    bool _full;
+    unsigned long _lastTime;
+    
+    bool _write(uint16_t delta, uint8_t event, uint8_t selection, uint8_t length);
+};
+
+// Replays a recorded log as an input source; as the keyboard's observer
+// it also compares the resulting state with the recording
+class InputReplay : public InputSource, public InputObserver {
+  public:
+    InputReplay(const uint8_t* data, size_t size);
+    
+    void begin();                    // Restart from the first record
+    InputEvent read();
+    unsigned long nextDeadlineMs() const;
+    void onEvent(unsigned long time, InputEvent event, uint8_t layer, uint8_t selection, uint8_t length);
+    
+    bool isFinished() const;
+    unsigned long getEventCount() const; // Events replayed so far
+    unsigned long getMismatches() const; // Events whose state differed
+    
+  private:
+    const uint8_t* _data;
+    size_t _size;
+    size_t _next;                    // Offset of the next record
+    const uint8_t* _expected;        // Record of the last event returned
+    unsigned long _start;
+    unsigned long _due;              // Time of the last record since _start
+    unsigned long _events;
+    unsigned long _mismatches;
+};
+
+#endif